@@ -1,48 +1,100 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
-#include <cstdlib>
+#include <chrono>
+#include <cstdint>
 #include <ctime>
 
-inline int randomInt(int max)
-{
-    return rand() / (RAND_MAX / max + 1);
-}
-
-inline int randomInt(int start, int end)
-{
-    return randomInt(end - start + 1) + start;
-}
+#include "random.hpp"
 
 class Game
 {
 public:
-    Game() {}
+    /** tick_rate is the updates a second, max_ticks_per_frame the most a single frame runs before the game slows down. */
+    Game(uint32_t tick_rate = 60, uint32_t max_ticks_per_frame = 4) : tick_rate(tick_rate), max_ticks_per_frame(max_ticks_per_frame) {}
     virtual ~Game() {}
     virtual bool Initialize() {return true;}
     virtual void New(time_t seeded_game = 0)
     {
         if (seeded_game == 0)
             seeded_game = time(NULL);
-        srand(seed = seeded_game);
+        random.seed(seed = seeded_game);
     }
     virtual void Run()
     {
+        ResetClock();
         while(true)
         {
             if (!Input())
                 break;
-            Update();
-            Draw();
+            Tick();
+            Draw(Interpolation());
         }
     }
+    /** Advances the game by one tick, 1 / tick_rate seconds whatever the frame rate. */
     virtual void Update() = 0;
     virtual bool Input() {return true;}
-    virtual void Draw() {}
+    /** alpha is how far into the next tick the frame is, from 0 to 1, to draw between the last two ticks. */
+    virtual void Draw(float alpha) {}
     virtual void Destroy() {}
 protected:
+    typedef std::chrono::steady_clock steady_clock;
+
+    /** Forgets the time since the last tick, for time the game was not running. */
+    void ResetClock()
+    {
+        last_tick = steady_clock::now();
+        accumulated = steady_clock::duration::zero();
+    }
+    /** Runs Update once for each tick due since the last call, at most max_ticks_per_frame times.
+      * Returns the number of ticks run, dropped_ticks is set to those given up to the cap. */
+    uint32_t Tick()
+    {
+        dropped_ticks = 0;
+        auto now = steady_clock::now();
+        accumulated += now - last_tick;
+        last_tick = now;
+
+        const auto tick = TickLength();
+        uint32_t ticks = 0;
+        while (accumulated >= tick && ticks < max_ticks_per_frame)
+        {
+            Update();
+            accumulated -= tick;
+            ticks++;
+        }
+
+        // Past the cap the game slows down instead of needing ever more ticks to catch up.
+        if (accumulated >= tick)
+        {
+            dropped_ticks = accumulated / tick;
+            accumulated %= tick;
+        }
+        return ticks;
+    }
+    float Interpolation() const
+    {
+        return std::chrono::duration<float>(accumulated).count() * tick_rate;
+    }
+    steady_clock::duration TickLength() const
+    {
+        return std::chrono::duration_cast<steady_clock::duration>(std::chrono::nanoseconds(1000000000 / tick_rate));
+    }
+
+    /** Updates a second. */
+    const uint32_t tick_rate;
+    /** Ticks a single frame runs at most, frames further apart slow the game down. */
+    const uint32_t max_ticks_per_frame;
+    /** Ticks the last call to Tick gave up to the cap. */
+    uint32_t dropped_ticks = 0;
+
     time_t seed = 0;
+    /** Reseeded by New, so everything drawn from it is the same when a seed is replayed. */
+    Random random;
 
+private:
+    steady_clock::time_point last_tick;
+    steady_clock::duration accumulated{};
 };
 
 #endif
@@ -2,11 +2,12 @@
 #define SDL_GAME_HPP
 
 #include "Game.hpp"
+#include "frame_stats.hpp"
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <string_view>
 #include <SDL.h>
-#include <SDL_image.h>
 
 enum SDLKeyMapping {
     SDL_KEY_A, SDL_KEY_B, SDL_KEY_X, SDL_KEY_Y,
@@ -22,11 +23,14 @@ enum SDLKeyMapping {
 
 constexpr uint32_t SCREEN_WIDTH = 1920;
 constexpr uint32_t SCREEN_HEIGHT = 1080;
+// While idle the loop still wakes this often, for changes that do not come with an event.
+constexpr int IDLE_WAKEUP_MS = 250;
 
 class SDLGame : public Game
 {
 public:
-    SDLGame(std::string_view window_title) : title(window_title) {}
+    SDLGame(std::string_view window_title, uint32_t tick_rate = 60, uint32_t max_ticks_per_frame = 4) :
+        Game(tick_rate, max_ticks_per_frame), title(window_title), launched(std::chrono::steady_clock::now()) {}
     virtual ~SDLGame() {}
     bool Initialize() override;
     void New(time_t seeded_game = 0) override {Game::New(seeded_game);}
@@ -44,10 +48,25 @@ protected:
     virtual void OnTouchUp(const SDL_TouchFingerEvent& event) {}
     virtual void OnButtonDown(const SDL_JoyButtonEvent& event) {}
     virtual void OnButtonUp(const SDL_JoyButtonEvent& event) {}
+    virtual void OnAxisMotion(const SDL_JoyAxisEvent& event) {}
+    /** The contents of every render target texture were lost and have to be drawn again. */
+    virtual void OnRenderTargetsReset() {}
+    /** True while the screen changes without input. When false after a frame, Run stops drawing and sleeps
+      * until the next event, or until a wakeup finds it true again. */
+    virtual bool Animating() {return true;}
 
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     const std::string title;
+    /** Phase timing of the frames Run went through. */
+    FrameStats frame_stats;
+    /** Ticks run since the last event. */
+    uint32_t ticks_since_input = 0;
+    /** Time from constructing the game, first thing in main, to the first frame presented. */
+    double startup_ms = 0;
+
+private:
+    std::chrono::steady_clock::time_point launched;
 };
 
 #endif
@@ -0,0 +1,94 @@
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Where a character is in the atlas of a font and how it sits on the line. */
+struct AssetGlyph
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    /** From the pen position to the left of the glyph and from the top of the line to its top. */
+    int16_t left;
+    int16_t top;
+    /** The pen moves this far right after the glyph. */
+    uint16_t advance;
+    uint16_t reserved;
+};
+
+/** An image in a pack. A font is its glyph atlas, white with the coverage of each pixel as its alpha. */
+struct AssetEntry
+{
+    char name[24];
+    uint32_t width;
+    uint32_t height;
+    /** From the start of the file, width * height SDL_PIXELFORMAT_RGBA8888 values stored row by row. */
+    uint32_t pixels;
+    /** From the start of the file, glyph_count AssetGlyph for the characters from first_char on. 0 if not a font. */
+    uint32_t glyphs;
+    uint16_t glyph_count;
+    uint16_t first_char;
+    uint16_t line_height;
+    uint16_t reserved;
+};
+
+/** An image to pack, see AssetEntry. */
+struct AssetImage
+{
+    std::string name;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> pixels;
+    std::vector<AssetGlyph> glyphs;
+    uint16_t first_char = 0;
+    uint16_t line_height = 0;
+};
+
+/** Images decoded at build time (see tools/asset_pack), ready to go to textures as they are.
+  *
+  * The file is an AssetPack::Header, an AssetEntry per image, then the pixels and glyphs they point to. It is
+  * read whole with one read, nothing in it needs converting. */
+class AssetPack
+{
+public:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    static constexpr uint32_t VERSION = 1;
+
+    /** Reads a pack, returns false if it is missing, unreadable or points outside itself. */
+    bool open(const char* filename);
+    /** Frees the pack, once its images went to textures it is no longer needed. */
+    void close();
+    bool is_open() const {return length > 0;}
+
+    /** The image called name, nullptr if there is none. */
+    const AssetEntry* find(std::string_view name) const;
+    const uint32_t* pixels(const AssetEntry& entry) const;
+    const AssetGlyph* glyphs(const AssetEntry& entry) const;
+    /** Bytes read by open. */
+    size_t size() const {return length;}
+
+    static bool write(const char* filename, const std::vector<AssetImage>& images);
+
+private:
+    const uint8_t* bytes() const {return reinterpret_cast<const uint8_t*>(words.data());}
+    const Header& header() const {return *reinterpret_cast<const Header*>(bytes());}
+    const AssetEntry* entries() const {return reinterpret_cast<const AssetEntry*>(bytes() + sizeof(Header));}
+
+    // Held as words so everything the file aligns to 4 bytes is aligned in memory too.
+    std::vector<uint32_t> words;
+    size_t length = 0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ATLAS_FONT_HPP
+#define ATLAS_FONT_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <SDL.h>
+
+#include "asset_pack.hpp"
+
+/** Makes a static texture of an image in a pack, blended by its alpha. Returns nullptr on failure. */
+SDL_Texture* create_texture(SDL_Renderer* renderer, const AssetPack& pack, const AssetEntry& entry);
+
+/** Text drawn a glyph at a time from the atlas of a font in an asset pack.
+  *
+  * The glyphs were rasterized when the pack was built, loading only makes the atlas a texture. Characters
+  * the font has no glyph for are skipped. */
+class AtlasFont
+{
+public:
+    AtlasFont() {}
+    ~AtlasFont() {unload();}
+    AtlasFont(const AtlasFont&) = delete;
+    AtlasFont& operator=(const AtlasFont&) = delete;
+
+    /** Loads the font called name from pack, false if there is no such font or its texture failed. */
+    bool load(SDL_Renderer* renderer, const AssetPack& pack, std::string_view name);
+    /** Drops the texture, which has to happen before its renderer is destroyed. */
+    void unload();
+
+    int height() const {return line_height;}
+    /** Width of text in pixels, at scale 1. */
+    int width(std::string_view text) const;
+    /** Draws text with its top left corner at x, y, scale times its size. Returns the width drawn. */
+    int draw(SDL_Renderer* renderer, int x, int y, std::string_view text, const SDL_Color& color,
+             float scale = 1) const;
+
+private:
+    const AssetGlyph* glyph(char c) const;
+
+    SDL_Texture* texture = nullptr;
+    std::vector<AssetGlyph> glyphs;
+    uint16_t first_char = 0;
+    int line_height = 0;
+};
+
+#endif
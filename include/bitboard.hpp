@@ -0,0 +1,384 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "puzzle.hpp"
+
+/** Fixed size set of bits spread over Words 64 bit words, bit 0 is the lowest bit of the first word. */
+template <size_t Words>
+struct BitMask
+{
+    std::array<uint64_t, Words> words{};
+
+    static constexpr uint32_t BITS = Words * 64;
+
+    /** Bits [0, n) set. */
+    static BitMask low(uint32_t n)
+    {
+        BitMask mask;
+        for (size_t i = 0; i < Words; i++)
+        {
+            if (n >= (i + 1) * 64)
+                mask.words[i] = ~0ULL;
+            else if (n > i * 64)
+                mask.words[i] = (1ULL << (n - i * 64)) - 1;
+        }
+        return mask;
+    }
+
+    bool any() const
+    {
+        uint64_t bits = 0;
+        for (const auto word : words)
+            bits |= word;
+        return bits != 0;
+    }
+
+    uint32_t count() const
+    {
+        uint32_t total = 0;
+        for (const auto word : words)
+            total += __builtin_popcountll(word);
+        return total;
+    }
+
+    /** Index of the lowest set bit, the mask must not be empty. */
+    uint32_t lowest() const
+    {
+        size_t i = 0;
+        while (!words[i]) i++;
+        return i * 64 + __builtin_ctzll(words[i]);
+    }
+
+    bool test(uint32_t bit) const {return words[bit / 64] >> (bit % 64) & 1;}
+    void set(uint32_t bit) {words[bit / 64] |= 1ULL << (bit % 64);}
+
+    /** Up to 64 bits starting at pos, returned in the low bits. */
+    uint64_t extract(uint32_t pos, uint32_t len) const
+    {
+        uint32_t word = pos / 64, shift = pos % 64;
+        uint64_t bits = words[word] >> shift;
+        if (shift && shift + len > 64 && word + 1 < Words)
+            bits |= words[word + 1] << (64 - shift);
+        return len == 64 ? bits : bits & ((1ULL << len) - 1);
+    }
+
+    /** Overwrites len bits starting at pos with the low bits of value. */
+    void deposit(uint32_t pos, uint32_t len, uint64_t value)
+    {
+        uint64_t field = len == 64 ? ~0ULL : (1ULL << len) - 1;
+        uint32_t word = pos / 64, shift = pos % 64;
+        words[word] = (words[word] & ~(field << shift)) | (value & field) << shift;
+        if (shift && shift + len > 64 && word + 1 < Words)
+        {
+            uint32_t spill = 64 - shift;
+            words[word + 1] = (words[word + 1] & ~(field >> spill)) | (value & field) >> spill;
+        }
+    }
+
+    BitMask operator<<(uint32_t n) const
+    {
+        BitMask result;
+        if (n < 64)
+        {
+            // Neighbor shifts by 1 or by a column height take this path, keep it branch free.
+            for (size_t i = Words - 1; i > 0; i--)
+                result.words[i] = words[i] << n | (n ? words[i - 1] >> (64 - n) : 0);
+            result.words[0] = words[0] << n;
+            return result;
+        }
+
+        uint32_t word = n / 64, shift = n % 64;
+        for (size_t i = Words; i-- > word;)
+        {
+            result.words[i] = words[i - word] << shift;
+            if (shift && i > word)
+                result.words[i] |= words[i - word - 1] >> (64 - shift);
+        }
+        return result;
+    }
+
+    BitMask operator>>(uint32_t n) const
+    {
+        BitMask result;
+        if (n < 64)
+        {
+            for (size_t i = 0; i + 1 < Words; i++)
+                result.words[i] = words[i] >> n | (n ? words[i + 1] << (64 - n) : 0);
+            result.words[Words - 1] = words[Words - 1] >> n;
+            return result;
+        }
+
+        uint32_t word = n / 64, shift = n % 64;
+        for (size_t i = 0; i + word < Words; i++)
+        {
+            result.words[i] = words[i + word] >> shift;
+            if (shift && i + word + 1 < Words)
+                result.words[i] |= words[i + word + 1] << (64 - shift);
+        }
+        return result;
+    }
+
+    BitMask operator~() const
+    {
+        BitMask result;
+        for (size_t i = 0; i < Words; i++)
+            result.words[i] = ~words[i];
+        return result;
+    }
+
+    BitMask& operator&=(const BitMask& other)
+    {
+        for (size_t i = 0; i < Words; i++)
+            words[i] &= other.words[i];
+        return *this;
+    }
+
+    BitMask& operator|=(const BitMask& other)
+    {
+        for (size_t i = 0; i < Words; i++)
+            words[i] |= other.words[i];
+        return *this;
+    }
+
+    BitMask operator&(const BitMask& other) const {BitMask result = *this; return result &= other;}
+    BitMask operator|(const BitMask& other) const {BitMask result = *this; return result |= other;}
+    bool operator==(const BitMask& other) const {return words == other.words;}
+    bool operator!=(const BitMask& other) const {return words != other.words;}
+};
+
+/** Puzzle stored as one bit mask per color, for searches and playouts that copy and match boards millions of times.
+  *
+  * Cells are laid out column by column from the left, each column from the bottom up, so (x, y) is bit
+  * x * height + (height - 1 - y). Gravity then squeezes bits towards the start of their column and
+  * collapsing an empty column shifts everything above it down by height bits.
+  *
+  * One or two words only, up to 128 cells, so a flood runs on a single integer. Wider boards had to flood a word
+  * at a time and ran at 0.1x to 0.4x of Puzzle. */
+template <size_t Words>
+class BitBoard
+{
+    static_assert(Words == 1 || Words == 2, "BitBoard floods as one 64 or 128 bit integer");
+
+public:
+    typedef BitMask<Words> mask;
+    static constexpr uint8_t MAX_COLORS = 8;
+
+    static bool fits(uint32_t width, uint32_t height, uint8_t colors)
+    {
+        return width * height <= mask::BITS && height <= 64 && colors <= MAX_COLORS;
+    }
+
+    BitBoard(const Puzzle& puzzle) : width(puzzle.width), height(puzzle.height), colors(puzzle.colors)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            not_bottom.set(x * height);
+            not_top.set(x * height + height - 1);
+        }
+        not_bottom = ~not_bottom;
+        not_top = ~not_top;
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            for (uint32_t y = 0; y < height; y++)
+            {
+                uint8_t c = puzzle.at(x, y);
+                if (c == Puzzle::EMPTY) continue;
+                cells[c].set(bit(x, y));
+                occupied.set(bit(x, y));
+            }
+        }
+    }
+
+    uint32_t bit(uint32_t x, uint32_t y) const {return x * height + height - 1 - y;}
+    uint32_t bit_x(uint32_t b) const {return b / height;}
+    uint32_t bit_y(uint32_t b) const {return height - 1 - b % height;}
+
+    uint8_t at(uint32_t x, uint32_t y) const {return color(bit(x, y));}
+
+    /** Color of the tile on bit b, Puzzle::EMPTY if there is none. */
+    uint8_t color(uint32_t b) const
+    {
+        if (!occupied.test(b))
+            return Puzzle::EMPTY;
+        for (uint8_t c = 0; c < colors; c++)
+        {
+            if (cells[c].test(b))
+                return c;
+        }
+        return Puzzle::EMPTY;
+    }
+
+    /** Every cell connected to bit b, whatever the size of the group. */
+    mask group(uint32_t b) const
+    {
+        uint8_t c = color(b);
+        return c == Puzzle::EMPTY ? mask() : flood(b, cells[c]);
+    }
+
+    /** Same as Puzzle::test, the group containing (x, y) or nothing if it has fewer than two cells. */
+    mask test(uint32_t x, uint32_t y) const
+    {
+        uint32_t b = bit(x, y);
+        uint8_t c = color(b);
+        if (c == Puzzle::EMPTY || !paired(b, cells[c]))
+            return mask();
+        return flood(b, cells[c]);
+    }
+
+    /** Every cell with a neighbor of the same color, in other words every cell that can be matched. */
+    mask movable() const
+    {
+        mask result;
+        for (uint8_t c = 0; c < colors; c++)
+        {
+            const mask& same = cells[c];
+            mask neighbors = ((same << 1) & not_bottom) | ((same >> 1) & not_top) | (same << height) | (same >> height);
+            result |= neighbors & same;
+        }
+        return result;
+    }
+
+    uint32_t match(uint32_t x, uint32_t y) {return match_bit(bit(x, y));}
+
+    uint32_t match_bit(uint32_t b)
+    {
+        uint8_t c = color(b);
+        if (c == Puzzle::EMPTY || !paired(b, cells[c]))
+            return 1;
+
+        mask found = flood(b, cells[c]);
+        uint32_t size = found.count();
+        if (size <= 1)
+            return 1;
+
+        mask keep = ~found;
+        for (uint8_t c = 0; c < colors; c++)
+            cells[c] &= keep;
+        occupied &= keep;
+
+        compact(found);
+        return size;
+    }
+
+    void compact(const mask& removed)
+    {
+        std::array<uint32_t, mask::BITS> empty_columns;
+        uint32_t empty_count = 0;
+
+        // Gravity, squeezing removed bits out of each column from the top down so the lower positions stay put.
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint32_t pos = x * height;
+            uint64_t gone = removed.extract(pos, height);
+            if (!gone) continue;
+
+            std::array<uint64_t, MAX_COLORS> column;
+            for (uint8_t c = 0; c < colors; c++)
+                column[c] = cells[c].extract(pos, height);
+            uint64_t filled = occupied.extract(pos, height);
+
+            while (gone)
+            {
+                uint32_t r = 63 - __builtin_clzll(gone);
+                gone &= ~(1ULL << r);
+                uint64_t below = (1ULL << r) - 1;
+                for (uint8_t c = 0; c < colors; c++)
+                    column[c] = (column[c] & below) | (column[c] >> 1 & ~below);
+                filled = (filled & below) | (filled >> 1 & ~below);
+            }
+
+            for (uint8_t c = 0; c < colors; c++)
+                cells[c].deposit(pos, height, column[c]);
+            occupied.deposit(pos, height, filled);
+
+            if (!filled)
+                empty_columns[empty_count++] = x;
+        }
+
+        // Collapse empty columns from the right so the positions of those to the left stay put.
+        while (empty_count--)
+        {
+            mask below = mask::low(empty_columns[empty_count] * height);
+            mask above = ~below;
+            for (uint8_t c = 0; c < colors; c++)
+                cells[c] = (cells[c] & below) | ((cells[c] >> height) & above);
+            occupied = (occupied & below) | ((occupied >> height) & above);
+        }
+    }
+
+    uint32_t tiles() const {return occupied.count();}
+    uint32_t count(uint8_t color) const {return cells[color].count();}
+    const mask& filled() const {return occupied;}
+
+    uint64_t hash() const
+    {
+        uint64_t hash = 0x9E3779B97F4A7C15ULL;
+        for (uint8_t c = 0; c < colors; c++)
+        {
+            for (const auto word : cells[c].words)
+            {
+                hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+                hash ^= hash >> 31;
+            }
+        }
+        return hash;
+    }
+
+    uint32_t width;
+    uint32_t height;
+    uint8_t colors;
+
+private:
+    /** Grows bit b by one step in every direction within same until it stops changing. */
+    mask flood(uint32_t b, const mask& same) const
+    {
+        // The whole board as one integer, each shift is a few instructions instead of a loop over the words.
+        typedef typename std::conditional<Words == 1, uint64_t, unsigned __int128>::type wide;
+        auto join = [](const mask& bits) -> wide
+        {
+            if constexpr (Words == 1)
+                return bits.words[0];
+            else
+                return wide(bits.words[1]) << 64 | bits.words[0];
+        };
+        const wide within = join(same), down = join(not_bottom), up = join(not_top);
+
+        wide found = wide(1) << b;
+        while (true)
+        {
+            wide grown = found | ((found << 1) & down) | ((found >> 1) & up) | found << height | found >> height;
+            grown &= within;
+            if (grown == found)
+                break;
+            found = grown;
+        }
+
+        mask result;
+        result.words[0] = static_cast<uint64_t>(found);
+        if constexpr (Words == 2)
+            result.words[1] = static_cast<uint64_t>(found >> 64);
+        return result;
+    }
+
+    /** True if bit b has a neighbor in same, the cells of its color. */
+    bool paired(uint32_t b, const mask& same) const
+    {
+        uint32_t r = b % height;
+        return (r > 0 && same.test(b - 1)) || (r + 1 < height && same.test(b + 1)) ||
+               (b >= height && same.test(b - height)) || (b + height < mask::BITS && same.test(b + height));
+    }
+
+    std::array<mask, MAX_COLORS> cells;
+    mask occupied;
+    // Everything but the bottom and top row of each column, they stop vertical shifts from wrapping into the next column.
+    mask not_bottom;
+    mask not_top;
+};
+
+#endif
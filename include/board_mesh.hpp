@@ -0,0 +1,78 @@
+#ifndef BOARD_MESH_HPP
+#define BOARD_MESH_HPP
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "modulation_bank.hpp"
+#include "puzzle.hpp"
+#include "tile_animation.hpp"
+
+/** Laid out as SDL_Vertex, so the mesh can be handed to SDL_RenderGeometry as is. */
+struct MeshVertex
+{
+    float x, y;
+    uint8_t r, g, b, a;
+    float u, v;
+};
+
+/** Tiles of a board as one list of colored quads, drawn with a single call whatever the size of the board.
+  *
+  * The game keeps two: the tiles of the columns that changed, drawn into the cached board, and the overlay of the
+  * selected and hinted groups drawn over it every frame. Tinted quads take the colors given to set_tints, which
+  * change every frame without building the mesh again.
+  *
+  * Tiles go at their place on the board, tile pixels a side, from an origin where the top left corner of the board
+  * is drawn. Tiles outside the bounds (columns and rows, all of them by default) are left out, so a view of part of
+  * a large board only builds what is in view. */
+class BoardMesh
+{
+public:
+    typedef std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> palette;
+
+    /** Removes every quad, origin and bounds stay. */
+    void clear();
+    /** Pixel position of the top left corner of the board for the quads added from now on. */
+    void set_origin(float x, float y);
+    /** Only tiles in columns [minx, maxx] and rows [miny, maxy] are added from now on. */
+    void set_bounds(uint32_t minx, uint32_t maxx, uint32_t miny, uint32_t maxy);
+    /** Adds the tiles of columns [minx, maxx]. tile is the size of a tile in pixels, quads leave a pixel of gap.
+      * Tiles still moving to their cell in falling are left out. */
+    void add_columns(const Puzzle& puzzle, const palette& colors, float tile, uint32_t minx, uint32_t maxx,
+                     const TileAnimation* falling = nullptr);
+    /** Adds every moving tile of falling where it is alpha ticks after its last update. */
+    void add_tweens(const TileAnimation& falling, const palette& colors, float tile, float alpha);
+    /** Adds a tinted tile on every cell of the group holding cell. */
+    void add_group(const Puzzle& puzzle, float tile, uint32_t cell);
+    /** Adds a small white mark in the middle of every cell of the group holding cell. */
+    void add_marks(const Puzzle& puzzle, float tile, uint32_t cell);
+    /** Gives the tile of the i-th group cell added the color of modulator i, counting cells out of bounds too.
+      * bank must have a modulator for every one of them. */
+    void set_tints(const ModulationBank& bank);
+
+    const std::vector<MeshVertex>& vertices() const {return vertex_list;}
+    /** Six per quad, two triangles. Can hold indices past index_count(), for quads of an earlier board. */
+    const std::vector<int>& indices() const {return index_list;}
+    int index_count() const {return quads() * 6;}
+    uint32_t quads() const {return vertex_list.size() / 4;}
+
+private:
+    void add_quad(float x, float y, float size, uint8_t r, uint8_t g, uint8_t b);
+    bool in_bounds(float x, float y) const;
+
+    std::vector<MeshVertex> vertex_list;
+    std::vector<int> index_list;
+    // First vertex of each tinted quad and the group cell it was added for.
+    std::vector<uint32_t> tinted;
+    std::vector<uint32_t> tinted_cells;
+    uint32_t group_cells = 0;
+    float origin_x = 0;
+    float origin_y = 0;
+    uint32_t min_x = 0;
+    uint32_t max_x = UINT32_MAX;
+    uint32_t min_y = 0;
+    uint32_t max_y = UINT32_MAX;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include <cstdint>
+
+/** Which part of the board the screen shows and how large its tiles are.
+  *
+  * Board positions are in tiles, screen positions in pixels from the top left of the view. The camera never zooms
+  * in past max_tile pixels a tile nor out past the whole board fitting the view, and keeps the board on screen:
+  * a board smaller than the view is centered, a larger one cannot be panned past its edges. */
+class Camera
+{
+public:
+    /** Shows a board of columns x rows tiles in a view of view_width x view_height pixels, zoomed in all the way
+      * and centered on the board. */
+    void reset(uint32_t columns, uint32_t rows, float view_width, float view_height, float max_tile);
+    /** Moves the board dx, dy pixels on screen. */
+    void pan(float dx, float dy);
+    /** Makes tiles factor times larger, the board position under (x, y) on screen stays there. */
+    void zoom(float factor, float x, float y);
+    /** Pans the least needed for tile (x, y) to be in view. */
+    void show(uint32_t x, uint32_t y);
+
+    /** Size of a tile on screen in pixels. */
+    float tile() const {return tile_size;}
+    bool zoomed_in() const {return tile_size >= max_tile;}
+    float screen_x(float board_x) const {return (board_x - left) * tile_size;}
+    float screen_y(float board_y) const {return (board_y - top) * tile_size;}
+    float board_x(float screen_x) const {return left + screen_x / tile_size;}
+    float board_y(float screen_y) const {return top + screen_y / tile_size;}
+
+    /** Columns and rows at least partly in view, the rest of the board need not be drawn. */
+    uint32_t min_x() const;
+    uint32_t max_x() const;
+    uint32_t min_y() const;
+    uint32_t max_y() const;
+
+    /** True if the view moved or zoomed since the last reset_changes. */
+    bool changed() const {return moved;}
+    void reset_changes() {moved = false;}
+
+private:
+    void clamp();
+    void move(float new_left, float new_top, float new_tile);
+
+    uint32_t columns = 1;
+    uint32_t rows = 1;
+    float view_width = 1;
+    float view_height = 1;
+    float min_tile = 1;
+    float max_tile = 1;
+    float tile_size = 1;
+    // Board position at the top left of the view.
+    float left = 0;
+    float top = 0;
+    bool moved = true;
+};
+
+#endif
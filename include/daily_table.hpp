@@ -0,0 +1,74 @@
+#ifndef DAILY_TABLE_HPP
+#define DAILY_TABLE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/** The board of one day and the score the solver reached on it. */
+struct DailyEntry
+{
+    uint32_t seed;
+    uint32_t par;
+    uint16_t remaining;
+    uint16_t reserved;
+};
+
+/** Binary file of the daily challenge boards of a run of consecutive days, with their par scores.
+  *
+  * The file is a DailyTable::Header followed by an entry per day in order, so a day is found with one seek and one
+  * read. The seed of a day does not come from the table, seed() derives it from the date alone and the table
+  * holds it only to check that it still deals the board the par was worked out on. */
+class DailyTable
+{
+public:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t first_day;
+        uint32_t count;
+        uint16_t width;
+        uint16_t height;
+        uint8_t colors;
+        uint8_t reserved[3];
+    };
+
+    /** Bumped whenever the board dealt for a seed or the seed of a day changes, older tables then fail to open. */
+    static constexpr uint32_t VERSION = 1;
+
+    DailyTable() {}
+    ~DailyTable() {close();}
+    DailyTable(const DailyTable&) = delete;
+    DailyTable& operator=(const DailyTable&) = delete;
+
+    /** Opens a table, returns false if it is missing or unreadable. Only the header is read. */
+    bool open(const char* filename);
+    void close();
+    bool is_open() const {return file != nullptr;}
+
+    /** True if the boards were dealt on a board of this size. */
+    bool matches(uint32_t width, uint32_t height, uint8_t colors) const
+    {
+        return header.width == width && header.height == height && header.colors == colors;
+    }
+    uint32_t first_day() const {return header.first_day;}
+    uint32_t size() const {return header.count;}
+    /** Reads the entry of day (see day_number), false if the table does not cover it. */
+    bool get(uint32_t day, DailyEntry& entry) const;
+
+    /** Writes entries, the first one for first_day and one for each following day. */
+    static bool write(const char* filename, const std::vector<DailyEntry>& entries, uint32_t first_day, uint32_t width,
+                      uint32_t height, uint8_t colors);
+
+    /** Days from 1970-01-01 to a date of the Gregorian calendar, month and day counted from 1. */
+    static uint32_t day_number(int year, uint32_t month, uint32_t day);
+    /** The seed every player gets on day, never 0. */
+    static uint32_t seed(uint32_t day);
+
+private:
+    FILE* file = nullptr;
+    Header header{};
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef FRAME_STATS_HPP
+#define FRAME_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Times the phases of each frame. The last FRAMES frames are kept in a ring buffer for the overlay,
+  * every frame since the start goes into a histogram of frame times. Times are in microseconds.
+  * Time the game loop spends asleep while nothing changes on screen is counted apart from the frames. */
+class FrameStats
+{
+public:
+    enum Phase {INPUT, UPDATE, DRAW, PRESENT, PHASES};
+
+    static constexpr uint32_t FRAMES = 256;
+    static constexpr uint32_t BUCKET_US = 500;
+    /** The last bucket counts every frame longer than the others cover. */
+    static constexpr uint32_t BUCKETS = 101;
+
+    struct Frame
+    {
+        uint32_t phases[PHASES];
+        uint32_t total;
+        uint32_t draw_calls;
+        /** Part of DRAW spent on the score and hint text. */
+        uint32_t text;
+    };
+
+    /** refresh_hz is the display rate, frames spanning more than one refresh missed a vsync. */
+    FrameStats(double refresh_hz = 60);
+
+    /** Starts timing a frame. */
+    void begin();
+    /** Charges the time since the last begin or mark to phase. */
+    void mark(Phase phase);
+    /** Records the frame. */
+    void end();
+    /** Counts calls made to the renderer during the frame. */
+    void count_draw_calls(uint32_t calls = 1) {current.draw_calls += calls;}
+    /** Charges time spent drawing text, the caller times it within a phase. */
+    void add_text(uint32_t us) {current.text += us;}
+
+    /** Frames in the ring buffer. */
+    size_t size() const {return count;}
+    /** Kept frame i, 0 being the oldest. */
+    const Frame& frame(size_t i) const {return ring[(next + FRAMES - count + i) % FRAMES];}
+    /** Frame time below which p percent of the kept frames are. */
+    uint32_t percentile(double p) const;
+    /** Time of a phase averaged over the kept frames. */
+    uint32_t average(Phase phase) const;
+    /** Draw calls averaged over the kept frames. */
+    double average_draw_calls() const;
+    /** Text time averaged over the kept frames. */
+    uint32_t average_text() const;
+    uint32_t interval() const {return interval_us;}
+
+    uint64_t frames() const {return total_frames;}
+    /** Refreshes the display showed a frame again since the start. */
+    uint64_t missed_vsyncs() const {return missed;}
+    /** Counts game ticks the loop gave up because a frame took too long, the game ran that much slower. */
+    void add_dropped_ticks(uint32_t ticks) {dropped += ticks;}
+    /** Ticks given up since the start. */
+    uint64_t dropped_ticks() const {return dropped;}
+
+    /** Charges time the loop slept waiting for input instead of drawing frames. */
+    void add_idle(uint32_t us, bool woken_by_event);
+    /** Fraction of the time since the start spent asleep. */
+    double idle_fraction() const;
+    /** Frames drawn per minute since the start. */
+    double frames_per_minute() const;
+
+    /** Writes the histogram of every frame time and the count of missed vsyncs as text. */
+    bool write(const char* filename) const;
+
+    static const char* name(Phase phase);
+
+private:
+    typedef std::chrono::steady_clock steady_clock;
+
+    uint32_t interval_us;
+    steady_clock::time_point last;
+    Frame current{};
+
+    std::vector<Frame> ring;
+    size_t next = 0;
+    size_t count = 0;
+    mutable std::vector<uint32_t> scratch;
+
+    std::vector<uint64_t> histogram;
+    uint64_t total_frames = 0;
+    uint64_t missed = 0;
+    uint64_t dropped = 0;
+
+    steady_clock::time_point started;
+    uint64_t idle_us = 0;
+    uint64_t idle_waits = 0;
+    uint64_t idle_timeouts = 0;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef HINT_HPP
+#define HINT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "puzzle.hpp"
+
+struct HintStats
+{
+    uint64_t playouts = 0;
+    double playouts_per_second = 0;
+    /** Time from the start of the search to the last change of the suggested move. */
+    double seconds_to_stable = 0;
+    double seconds = 0;
+    /** False once the search used up its playouts or there is nothing to search. */
+    bool searching = false;
+};
+
+/** Suggests the next move with a Monte Carlo tree search running on its own thread.
+  *
+  * The game thread hands boards over with search and reads the current best move with hint, neither ever waits
+  * on the search. A new board cancels the search on the previous one. */
+class HintEngine
+{
+public:
+    struct Options
+    {
+        /** The search stops after this many playouts on a board. */
+        uint32_t max_playouts = 20000;
+        /** Tree nodes kept, past that the leaves are only played out. */
+        uint32_t max_nodes = 1 << 16;
+        /** UCT exploration constant, rewards are the final score over the best final score seen. */
+        double exploration = 0.4;
+        uint64_t seed = 1;
+    };
+
+    HintEngine() {}
+    HintEngine(const Options& opts) : options(opts) {}
+    ~HintEngine() {stop();}
+    HintEngine(const HintEngine&) = delete;
+    HintEngine& operator=(const HintEngine&) = delete;
+
+    /** Starts the worker thread. */
+    void start();
+    /** Stops the worker thread, waiting for the current iteration to finish. */
+    void stop();
+
+    /** Starts searching a copy of puzzle, dropping the search on the board given before. */
+    void search(const Puzzle& puzzle);
+    /** Cell (Puzzle::index) of the group the search currently suggests for the board given last,
+      * false until the search has one. */
+    bool hint(uint32_t& cell) const;
+    HintStats stats() const;
+
+private:
+    struct Request
+    {
+        Puzzle board;
+        uint32_t generation;
+    };
+
+    void work();
+    void run(const Request& request);
+
+    Options options;
+    std::thread worker;
+    std::atomic<bool> quit{false};
+    // Next board to search, owned by whichever thread takes it out.
+    std::atomic<Request*> pending{nullptr};
+    // The worker sleeps on wake while there is no board to search, waiting tells search it has to be woken.
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> waiting{false};
+    // Only touched by the game thread.
+    uint32_t generation = 0;
+
+    // Generation of the board searched in the upper half, suggested cell in the lower one.
+    std::atomic<uint64_t> answer{0};
+    std::atomic<uint64_t> playouts{0};
+    std::atomic<uint64_t> elapsed_us{0};
+    std::atomic<uint64_t> stable_us{0};
+    std::atomic<bool> searching{false};
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef HISTORY_HPP
+#define HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "puzzle.hpp"
+
+/** Undo and redo for a Puzzle, storing what each match removed instead of copies of the board.
+  *
+  * A record is the color of the group, its cells as varint gaps between sorted indices and the columns
+  * the match emptied. Gravity and column collapse follow from those, so undoing a move costs about as
+  * much as the move did and a game of a few hundred moves takes a few kilobytes. */
+class History
+{
+public:
+    /** max_bytes bounds the log, the oldest moves are forgotten past it. 0 for no bound. */
+    History(size_t max_bytes = 0) : limit(max_bytes) {}
+
+    /** Same as Puzzle::match, recording the move. Moves that could have been redone are dropped. */
+    uint32_t match(Puzzle& puzzle, uint32_t x, uint32_t y, Puzzle::move_list* moves = nullptr);
+    /** Takes back the last move, returns the size of the group put back or 0 if there is nothing to undo. */
+    uint32_t undo(Puzzle& puzzle);
+    /** Plays the last undone move again, returns the size of the group removed or 0 if there is nothing to redo. */
+    uint32_t redo(Puzzle& puzzle, Puzzle::move_list* moves = nullptr);
+
+    bool can_undo() const {return position > 0;}
+    bool can_redo() const {return position < offsets.size();}
+    /** Moves recorded, undone ones included. */
+    size_t size() const {return offsets.size();}
+    /** Bytes held by the history. */
+    size_t memory() const;
+    void clear();
+
+private:
+    void write(uint32_t value);
+    uint32_t read(size_t& offset) const;
+    void decode(size_t offset);
+    void trim();
+
+    size_t limit;
+    std::vector<uint8_t> log;
+    // Start of each move in log, and how many of them are applied.
+    std::vector<uint32_t> offsets;
+    size_t position = 0;
+
+    Puzzle::cell_list cells;
+    Puzzle::cell_list columns;
+    uint8_t color = Puzzle::EMPTY;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MODULATION_BANK_HPP
+#define MODULATION_BANK_HPP
+
+#include <cstdint>
+#include <vector>
+
+/** Many pulsing colors at once, each with its own colors, period and phase, so every tile can pulse on its own.
+  *
+  * A modulator's place in its cycle is a 32 bit fixed point phase, a whole cycle being 2^32, that wraps around on
+  * its own. Colors follow a triangle wave of the phase, computed with shifts and multiplies only. Each field is an
+  * array of its own and update and evaluate are plain loops over them. */
+class ModulationBank
+{
+public:
+    enum Channel {RED, GREEN, BLUE, ALPHA, CHANNELS};
+    /** Modulators are stored and updated in blocks of this many, fixed size loops the compiler vectorizes at -O2. */
+    static constexpr uint32_t LANES = 16;
+
+    void clear();
+    /** Adds a modulator going from min to max and back (RGBA8, red in the low byte) every period ticks,
+      * phase into its cycle (only its fraction counts, so negative phases lag behind). Returns its index. */
+    uint32_t add(uint32_t min, uint32_t max, uint32_t period, float phase = 0);
+    /** Advances every modulator by a tick. */
+    void update();
+    /** Computes the colors of every modulator alpha ticks (0 to 1) after the last update. */
+    void evaluate(float alpha);
+
+    uint32_t size() const {return count;}
+    /** Color computed by the last evaluate. */
+    uint8_t red(uint32_t i) const {return color[RED][i];}
+    uint8_t green(uint32_t i) const {return color[GREEN][i];}
+    uint8_t blue(uint32_t i) const {return color[BLUE][i];}
+    uint8_t alpha(uint32_t i) const {return color[ALPHA][i];}
+
+private:
+    uint32_t count = 0;
+    std::vector<uint32_t> phase;
+    std::vector<uint32_t> increment;
+    // Per channel, the color at the bottom of the wave and the distance to the top of it.
+    std::vector<int32_t> base[CHANNELS];
+    std::vector<int32_t> range[CHANNELS];
+    std::vector<uint8_t> color[CHANNELS];
+    // evaluate scratch, the wave of every modulator from 0 to 65535.
+    std::vector<int32_t> level;
+};
+
+#endif
@@ -2,39 +2,123 @@
 #define PUZZLE_HPP
 
 #include <cstdint>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
-struct pair_hash {
-
-    size_t operator()(const std::pair<uint32_t, uint32_t>& pair) const
-    {
-        return static_cast<size_t>(pair.first) << 32 | pair.second;
-    }
-};
+#include "random.hpp"
 
 class Puzzle
 {
 public:
-    typedef std::unordered_set<std::pair<uint32_t, uint32_t>, pair_hash> point_set;
+    typedef std::vector<uint32_t> cell_list;
+    /** A tile compact moved, from and to are indices into data. */
+    struct TileMove
+    {
+        uint32_t from;
+        uint32_t to;
+    };
+    typedef std::vector<TileMove> move_list;
+    /** to of the cells a match removed. */
+    static constexpr uint32_t REMOVED = UINT32_MAX;
     static constexpr uint8_t EMPTY = 255;
+    static constexpr uint32_t NO_GROUP = UINT32_MAX;
+    /** Random stream boards are dealt from, so the board of a seed does not depend on what else the game draws. */
+    static constexpr uint64_t RANDOM_STREAM = 1;
 
-    Puzzle(uint32_t w, uint32_t h, uint8_t c = 5) : width(w), height(h), colors(c), data(w * h, EMPTY)
+    /** Deals a random board, the same seed deals the same board on every platform. */
+    Puzzle(uint32_t w, uint32_t h, uint8_t c = 5, uint64_t seed = 0) : width(w), height(h), colors(c), data(w * h, EMPTY),
+        random(seed, RANDOM_STREAM), visited(w * h, 0), labels(w * h, NO_GROUP), heights(w, 0), removed(w, 0), lowest(w, 0)
     {
+        touched.reserve(w);
+        emptied.reserve(w);
+        group.reserve(w * h);
+        sizes.reserve(w * h);
+        free_labels.reserve(w * h);
         randomize();
     }
-    uint8_t at(uint32_t x, uint32_t y) const {return data[y * width + x];}
-    uint32_t match(uint32_t x, uint32_t y);
-    point_set test(uint32_t x, uint32_t y) const;
+    uint8_t at(uint32_t x, uint32_t y) const {return data[index(x, y)];}
+    uint32_t index(uint32_t x, uint32_t y) const {return x * height + y;}
+    uint32_t cell_x(uint32_t cell) const {return cell / height;}
+    uint32_t cell_y(uint32_t cell) const {return cell % height;}
+    /** Removes the group at (x, y) if it has two or more cells, returns its size. moves as in compact. */
+    uint32_t match(uint32_t x, uint32_t y, move_list* moves = nullptr);
+    /** Cells connected to (x, y) as indices into data, empty if the group has fewer than two cells.
+      * The list is scratch space owned by the puzzle and is only valid until the next call. */
+    const cell_list& test(uint32_t x, uint32_t y) const;
+
+    /** Connected component (group) the cell belongs to, NO_GROUP for empty cells.
+      * Labels are stable for groups untouched by a match, other groups may be renumbered. */
+    uint32_t label(uint32_t x, uint32_t y) const {return labels[index(x, y)];}
+    /** Number of cells in the group containing (x, y), 0 for empty cells. */
+    uint32_t group_size(uint32_t x, uint32_t y) const
+    {
+        uint32_t group_label = label(x, y);
+        return group_label == NO_GROUP ? 0 : sizes[group_label];
+    }
+    /** True while at least one group of two or more cells remains. */
+    bool has_moves() const {return movable_groups > 0;}
+    /** Picks a random cell of a group of two or more, scanning the board if random probes keep missing.
+      * False when there are no moves. */
+    bool random_move(Random& random, uint32_t& x, uint32_t& y) const;
 
+    /** Deals a new board from the next numbers of the puzzle's generator. */
     void randomize();
-    void compact(const point_set& hints);
+    /** Applies gravity and collapses empty columns after the cells in hints were emptied.
+      * When moves is given it is filled with the hinted cells, to REMOVED, followed by every tile that changed cell. */
+    void compact(const cell_list& hints, move_list* moves = nullptr);
+    /** Undoes a match, puts back a group of color whose cells (sorted, indices from before the match) were removed.
+      * columns lists, in order, the columns the match emptied and compact took out. */
+    void restore(const cell_list& cells, uint8_t color, const cell_list& columns);
+    /** Recomputes every group label from scratch. */
+    void relabel();
+
+    /** Leftmost and rightmost columns whose cells changed since the last reset_changes, first > second if none did.
+      * Lets a cached drawing of the board redraw only those columns. */
+    std::pair<uint32_t, uint32_t> changes() const {return {changed_minx, changed_maxx};}
+    void reset_changes() {changed_minx = width; changed_maxx = 0;}
 
     uint32_t width;
     uint32_t height;
     uint8_t colors;
+    /** Cells stored column by column (see index), so each column is contiguous and gravity never leaves its column. */
     std::vector<uint8_t> data;
 
+private:
+    Random random;
+
+    // Flood fill scratch, reused between calls so queries do not allocate.
+    // A cell has been visited by the current query when visited[cell] == generation.
+    mutable cell_list group;
+    mutable std::vector<uint32_t> visited;
+    mutable uint32_t generation = 0;
+
+    void next_generation() const;
+    void relabel(uint32_t minx, uint32_t maxx);
+    void relabel(uint32_t x, uint32_t first_y, uint32_t last_y);
+    void flood(uint32_t start);
+    void move_columns(uint32_t first, uint32_t last, uint32_t to);
+    void clear_columns(uint32_t first, uint32_t last);
+    void set_label(uint32_t cell, uint32_t group_label);
+    void mark_changed(uint32_t minx, uint32_t maxx);
+
+    // Component labeling, sizes is indexed by label and free_labels holds labels with no cells.
+    std::vector<uint32_t> labels;
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> free_labels;
+    uint32_t movable_groups = 0;
+
+    // Tiles in each column, they sit in its bottom rows. Columns with tiles are [0, used_columns), compact keeps
+    // them together on the left. Empty cells always have NO_GROUP as label.
+    std::vector<uint32_t> heights;
+    uint32_t used_columns = 0;
+    // compact scratch, per column the cells the match removed and the lowest row it removed.
+    std::vector<uint32_t> removed;
+    std::vector<uint32_t> lowest;
+    cell_list touched;
+    cell_list emptied;
+
+    uint32_t changed_minx = 0;
+    uint32_t changed_maxx = 0;
 };
 
 
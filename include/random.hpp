@@ -0,0 +1,87 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/** Steps state and returns the next splitmix64 output, used to expand seeds. */
+inline uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/** xoshiro256** generator. Unlike rand() every instance has its own state and a seed gives the same
+  * numbers on every platform, so boards can be dealt on any thread and match between the Switch and the host tools.
+  *
+  * Generators seeded alike but on different streams give unrelated numbers. */
+class Random
+{
+public:
+    explicit Random(uint64_t value = 0, uint64_t stream = 0) {seed(value, stream);}
+
+    void seed(uint64_t value, uint64_t stream = 0)
+    {
+        uint64_t mix = stream;
+        uint64_t expand = value ^ splitmix64(mix);
+        for (auto& word : state)
+            word = splitmix64(expand);
+    }
+
+    uint64_t next()
+    {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /** Uniform in [0, bound), bound must not be 0. */
+    uint32_t below(uint32_t bound)
+    {
+        // Lemire's multiply and shift, retrying the few low products that would favor some results.
+        uint64_t product = (next() >> 32) * bound;
+        if (static_cast<uint32_t>(product) < bound)
+        {
+            uint32_t threshold = -bound % bound;
+            while (static_cast<uint32_t>(product) < threshold)
+                product = (next() >> 32) * bound;
+        }
+        return product >> 32;
+    }
+
+    /** Uniform in [start, end]. */
+    int range(int start, int end) {return start + below(end - start + 1);}
+
+    /** Fills count bytes with values in [0, bound), eight bytes per step of the generator. */
+    void fill(uint8_t* out, size_t count, uint8_t bound)
+    {
+        // Bytes at or above limit are thrown away so every value stays equally likely.
+        uint32_t limit = 256 - 256 % bound;
+        size_t i = 0;
+        while (i < count)
+        {
+            uint64_t bits = next();
+            for (int byte = 0; byte < 8 && i < count; byte++, bits >>= 8)
+            {
+                uint8_t value = bits & 0xFF;
+                if (value < limit)
+                    out[i++] = value % bound;
+            }
+        }
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+
+    uint64_t state[4];
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "puzzle.hpp"
+
+/** Recorded games. A replay file is a ReplayHeader followed by one varint per action: 0 for an undo,
+  * 1 for a redo and the cell (Puzzle::index) clicked plus 2 for a move. With REPLAY_HASHES every action
+  * is followed by the 8 byte board_hash of the board after it. */
+struct ReplayHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    uint16_t width;
+    uint16_t height;
+    uint8_t colors;
+    uint8_t flags;
+    uint8_t reserved[2];
+};
+
+enum ReplayFlags
+{
+    REPLAY_HASHES = 1,
+};
+
+/** Hash of the colors of a board. Each column is hashed on its own with FNV-1a, mixed with its position and the
+  * columns are added up, so after a match only the columns that changed have to be hashed again. */
+uint64_t board_hash(const Puzzle& puzzle);
+
+/** board_hash of a board kept up to date as it changes, from the columns Puzzle::changes reports. */
+class BoardHash
+{
+public:
+    /** Hashes every column of puzzle and resets its changes. */
+    uint64_t reset(Puzzle& puzzle);
+    /** Hashes again the columns changed since the last reset_changes and resets them. */
+    uint64_t update(Puzzle& puzzle);
+    uint64_t value() const {return hash;}
+
+private:
+    std::vector<uint64_t> columns;
+    uint64_t hash = 0;
+};
+
+/** Records the actions of a game in memory and leaves the file to a thread of its own, so the game thread never
+  * waits on a write. Actions reach the file when flushed, the game flushes at game over, and on close. */
+class ReplayWriter
+{
+public:
+    ReplayWriter() {}
+    ~ReplayWriter() {close();}
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    /** Starts a replay of the board dealt by seed, replacing the file, and the thread writing it. */
+    bool open(const char* filename, uint64_t seed, const Puzzle& puzzle, bool hashes = false);
+    /** Writes the actions still recorded and stops the writing thread. */
+    void close();
+    bool is_open() const {return worker.joinable();}
+
+    /** Records a move on cell, puzzle is the board after it. */
+    void move(uint32_t cell, const Puzzle& puzzle) {action(cell + 2, puzzle);}
+    void undo(const Puzzle& puzzle) {action(0, puzzle);}
+    void redo(const Puzzle& puzzle) {action(1, puzzle);}
+    /** Queues the actions recorded so far for writing, never waits on the file system. */
+    void flush();
+
+private:
+    void action(uint32_t value, const Puzzle& puzzle);
+    void work();
+
+    // Only touched by the game thread.
+    uint8_t flags = 0;
+    std::vector<uint8_t> recorded;
+
+    std::thread worker;
+    std::mutex queue_mutex;
+    std::condition_variable wake;
+    std::vector<uint8_t> queue;
+    bool quit = false;
+
+    // Only touched by the writing thread once it runs.
+    FILE* file = nullptr;
+};
+
+/** A replay loaded in memory, played back on a board dealt from its seed. */
+class Replay
+{
+public:
+    /** Version 2 changed board_hash to the column hash, replays of version 1 load if they have no hashes. */
+    static constexpr uint32_t VERSION = 2;
+
+    /** Reads a replay, dropping a last action cut short by a crash. Fails on a varint too long for a uint32_t,
+      * so play only ever sees complete actions. */
+    bool load(const char* filename);
+
+    /** The board the game started from. */
+    Puzzle deal() const {return Puzzle(header.width, header.height, header.colors, header.seed);}
+    /** Plays every action on puzzle, a board from deal(). Fails at the first action that cannot be played or
+      * whose board hash differs from the recorded one, actions is then the number played before it.
+      * hashes gets the hash of the board after each action if given. Boards are only hashed for replays with
+      * hashes or when hashes is given, puzzle's changes are reset then. */
+    bool play(Puzzle& puzzle, uint32_t& score, uint32_t& actions, std::vector<uint64_t>* hashes = nullptr) const;
+
+    const ReplayHeader& info() const {return header;}
+    bool has_hashes() const {return header.flags & REPLAY_HASHES;}
+
+private:
+    ReplayHeader header{};
+    std::vector<uint8_t> data;
+    // Replays without undo skip the history, which keeps playback to the cost of the matches.
+    bool has_undo = false;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SCORE_STORE_HPP
+#define SCORE_STORE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** A finished game. */
+struct ScoreRecord
+{
+    uint64_t seed;
+    uint32_t score;
+    /** Day the game ended on, see DailyTable::day_number. */
+    uint32_t day;
+    uint16_t remaining;
+    /** Kept apart in HighScores, below HighScores::MODES. */
+    uint8_t mode;
+    uint8_t reserved[5];
+};
+
+/** Best games and totals of each mode, everything the store keeps. */
+struct HighScores
+{
+    static constexpr uint32_t MODES = 4;
+    static constexpr uint32_t TOP = 10;
+
+    struct Stats
+    {
+        uint32_t games;
+        uint32_t cleared;
+        uint64_t total_score;
+    };
+
+    /** Counts a game and keeps it if it is among the TOP best of its mode. */
+    void add(const ScoreRecord& record);
+    /** Best score of a mode, 0 before its first game. */
+    uint32_t best(uint8_t mode) const {return count[mode] ? top[mode][0].score : 0;}
+
+    Stats stats[MODES];
+    /** Best first, count[mode] of them are used. */
+    ScoreRecord top[MODES][TOP];
+    uint32_t count[MODES];
+};
+
+/** High scores kept on the SD card by a thread of their own, so the game thread never waits on a write.
+  *
+  * Each game is appended to a journal, every COMPACT_EVERY games the scores are written whole to a snapshot
+  * next to a temporary file and renamed over it, then the journal starts over. Journal entries are numbered and
+  * checksummed: loading reads the snapshot and replays the entries past it, stopping at one a crash cut short,
+  * so a crash at any point loses at most the games not yet written. */
+class ScoreStore
+{
+public:
+    struct SnapshotHeader
+    {
+        char magic[4];
+        uint32_t version;
+        /** Games folded into the snapshot, the journal goes on from there. */
+        uint32_t sequence;
+        uint32_t checksum;
+    };
+
+    struct JournalEntry
+    {
+        uint32_t sequence;
+        uint32_t checksum;
+        ScoreRecord record;
+    };
+
+    /** What the writing thread did, for the tools. */
+    struct IoStats
+    {
+        uint32_t appended;
+        uint32_t snapshots;
+        uint32_t failures;
+        uint32_t worst_append_us;
+        uint32_t worst_snapshot_us;
+    };
+
+    static constexpr uint32_t VERSION = 1;
+    /** Journal entries written before the scores are compacted into a new snapshot. */
+    static constexpr uint32_t COMPACT_EVERY = 16;
+
+    ScoreStore() {}
+    ~ScoreStore() {close();}
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    /** Loads the scores and starts the writing thread. Returns false if nothing could be read, the store then
+      * starts empty and still saves. */
+    bool open(const std::string& snapshot, const std::string& journal);
+    /** Writes the games still queued and stops the writing thread. */
+    void close();
+
+    /** Adds a finished game to scores() at once and queues it for writing, never waits on the file system. */
+    void add(const ScoreRecord& record);
+    /** Waits until every game added so far is written. */
+    void flush();
+
+    const HighScores& scores() const {return current;}
+    IoStats io_stats();
+
+private:
+    void work(bool compact_first);
+    bool append(const std::vector<JournalEntry>& entries);
+    bool compact();
+
+    std::string snapshot_file;
+    std::string journal_file;
+    // Only touched by the game thread.
+    HighScores current{};
+    uint32_t sequence = 0;
+
+    std::thread worker;
+    std::mutex queue_mutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    std::vector<JournalEntry> queue;
+    uint32_t written_sequence = 0;
+    bool quit = false;
+    IoStats io{};
+
+    // Only touched by the writing thread once it runs.
+    HighScores saved{};
+    uint32_t saved_sequence = 0;
+    uint32_t journaled = 0;
+    FILE* journal = nullptr;
+};
+
+#endif
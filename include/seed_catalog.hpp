@@ -0,0 +1,84 @@
+#ifndef SEED_CATALOG_HPP
+#define SEED_CATALOG_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "random.hpp"
+
+/** What the solver found out about the board dealt by a seed. */
+struct SeedEntry
+{
+    uint32_t seed;
+    uint32_t score;
+    uint16_t remaining;
+    uint8_t difficulty;
+    uint8_t reserved;
+};
+
+/** Binary file of classified seeds sorted by difficulty then seed.
+  *
+  * The file is a SeedCatalog::Header followed by the entries. Only the header and the entries a binary
+  * search touches are read, so the catalog can be much bigger than what is worth loading on the console. */
+class SeedCatalog
+{
+public:
+    /** Difficulty classes, from the narrowest beam search that clears the board. */
+    enum Difficulty {EASY, NORMAL, HARD, UNSOLVED, DIFFICULTIES};
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint16_t width;
+        uint16_t height;
+        uint8_t colors;
+        uint8_t reserved[3];
+    };
+
+    /** Bumped whenever the board dealt for a seed changes, older catalogs then fail to open. */
+    static constexpr uint32_t VERSION = 2;
+
+    SeedCatalog() {}
+    ~SeedCatalog() {close();}
+    SeedCatalog(const SeedCatalog&) = delete;
+    SeedCatalog& operator=(const SeedCatalog&) = delete;
+
+    /** Opens a catalog and finds where each difficulty starts, returns false if it is missing or unreadable. */
+    bool open(const char* filename);
+    void close();
+    bool is_open() const {return file != nullptr;}
+
+    /** True if the seeds were dealt on a board of this size. */
+    bool matches(uint32_t width, uint32_t height, uint8_t colors) const
+    {
+        return header.width == width && header.height == height && header.colors == colors;
+    }
+    uint32_t size() const {return header.count;}
+    uint32_t size(uint8_t difficulty) const {return first[difficulty + 1] - first[difficulty];}
+    /** Reads the index-th seed of a difficulty. */
+    bool get(uint8_t difficulty, uint32_t index, SeedEntry& entry) const;
+    /** Reads a seed of a difficulty drawn from random. Picks only cover the catalog if random is left to run
+      * between them, never reseeded from what it picked. */
+    bool pick(uint8_t difficulty, Random& random, SeedEntry& entry) const
+    {
+        return size(difficulty) > 0 && get(difficulty, random.below(size(difficulty)), entry);
+    }
+
+    /** Sorts entries and writes them as a catalog. */
+    static bool write(const char* filename, std::vector<SeedEntry>& entries, uint32_t width, uint32_t height, uint8_t colors);
+
+    static const char* name(uint8_t difficulty);
+
+private:
+    bool read(uint32_t index, SeedEntry& entry) const;
+
+    FILE* file = nullptr;
+    Header header{};
+    // Index of the first entry of each difficulty, first[DIFFICULTIES] is the entry count.
+    uint32_t first[DIFFICULTIES + 1] = {};
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "puzzle.hpp"
+
+/** Zobrist hashing of Puzzle::data, one random key per (cell, color) pair. */
+class Zobrist
+{
+public:
+    Zobrist(uint32_t cells, uint8_t colors, uint64_t seed = 0x5A0B5157ULL);
+    uint64_t hash(const Puzzle& puzzle) const;
+    /** Key of a tile of color on cell, hashes change by xoring the keys of the tiles that came and went. */
+    uint64_t key(uint32_t cell, uint8_t color) const {return keys[cell * colors + color];}
+private:
+    uint8_t colors;
+    std::vector<uint64_t> keys;
+};
+
+struct Solution
+{
+    /** Cell (Puzzle::index) clicked for each move, relative to the board at that point of the game. */
+    std::vector<uint32_t> moves;
+    uint32_t score = 0;
+    uint32_t remaining = 0;
+    /** True if the search space was exhausted, the solution is then proven optimal. */
+    bool complete = false;
+};
+
+struct SolverStats
+{
+    /** Board representation the search ran on, picked from the size of the puzzle. */
+    const char* backend = "";
+    uint32_t threads = 1;
+    uint64_t nodes = 0;
+    uint64_t table_probes = 0;
+    uint64_t table_hits = 0;
+    double seconds = 0;
+    double seconds_to_best = 0;
+};
+
+class Solver
+{
+public:
+    enum Mode {EXACT, BEAM};
+    enum Objective {MAX_SCORE, CLEAR_BOARD};
+
+    struct Options
+    {
+        Mode mode = EXACT;
+        Objective objective = MAX_SCORE;
+        /** The transposition table holds 2^table_bits entries. */
+        uint32_t table_bits = 20;
+        /** Exact search gives up after this many nodes, 0 for no limit. */
+        uint64_t node_limit = 0;
+        uint32_t beam_width = 512;
+        /** Exact search starts from the result of a beam search this wide, which tightens the bound early. 0 to disable. */
+        uint32_t warm_start_width = 64;
+        /** Threads sharing the exact search, beam search always runs on one. */
+        uint32_t threads = 1;
+        /** Search on Puzzle itself even when a bitboard would fit, for comparisons. */
+        bool force_puzzle = false;
+    };
+
+    Solver(const Options& opts) : options(opts) {}
+    /** Searches on a BitBoard when the puzzle fits in 128 bits, otherwise on copies of the puzzle. */
+    Solution solve(const Puzzle& puzzle);
+    const SolverStats& stats() const {return solver_stats;}
+
+    /** Score of removing a group of size cells, as awarded by the game. */
+    static uint32_t score(uint32_t size) {return (size - 1) * (size - 1);}
+
+private:
+    template <typename Backend>
+    Solution run(const Puzzle& puzzle, const char* name);
+
+    Options options;
+    SolverStats solver_stats;
+};
+
+#endif
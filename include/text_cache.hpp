@@ -0,0 +1,62 @@
+#ifndef TEXT_CACHE_HPP
+#define TEXT_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL.h>
+
+#include "atlas_font.hpp"
+
+/** Text drawn from textures, so a string is only laid out glyph by glyph when it is drawn for the first time.
+  *
+  * Each string is rendered once into a texture of its own, kept until MAX_TEXTS others were drawn more recently.
+  * Numbers are copied a digit at a time from a strip of the ten digits rendered once, so a changing score never
+  * renders text. Every texture is rendered again after clear, which SDL_RENDER_TARGETS_RESET calls for. */
+class TextCache
+{
+public:
+    static constexpr uint32_t MAX_TEXTS = 16;
+
+    TextCache(SDL_Renderer* renderer, const AtlasFont& font, const SDL_Color& color);
+    ~TextCache();
+
+    /** Draws text with its top left corner at x, y. Returns the width drawn. */
+    int draw(int x, int y, std::string_view text);
+    /** Draws value in digits from the strip. Returns the width drawn. */
+    int draw_number(int x, int y, uint32_t value);
+    /** Drops every texture. */
+    void clear();
+
+    /** Strings rendered from the font since the start, a frame that draws the same text as the last renders none. */
+    uint64_t renders() const {return rendered;}
+    /** Textures copied to the renderer since the start, one per string and one per digit. */
+    uint64_t draw_calls() const {return calls;}
+
+private:
+    struct Text
+    {
+        std::string text;
+        SDL_Texture* texture;
+        int width;
+        uint64_t last_drawn;
+    };
+
+    SDL_Texture* render(const char* text, int width);
+
+    SDL_Renderer* renderer;
+    const AtlasFont& font;
+    SDL_Color color;
+    int height;
+
+    std::vector<Text> texts;
+    SDL_Texture* digits = nullptr;
+    bool strip_rendered = false;
+    int digit_x[11];
+    uint64_t draws = 0;
+    uint64_t rendered = 0;
+    uint64_t calls = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef TILE_ANIMATION_HPP
+#define TILE_ANIMATION_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "puzzle.hpp"
+
+/** Tiles falling and sliding to the cells a move sent them to, from the move list Puzzle::compact gives.
+  *
+  * Each moving tile is a tween from where it was to its new cell, eased like a fall. Tweens are kept as parallel
+  * arrays so the per tick update is one pass over their progress, with no branches the compiler cannot vectorize.
+  * The cells tiles are headed to are flagged, the still drawing of the board leaves them out until they land.
+  * Positions are in tiles, x to the right and y down as on the board. */
+class TileAnimation
+{
+public:
+    /** Drops every tween and sizes the board. */
+    void reset(uint32_t width, uint32_t height);
+    /** Starts moving the tiles of moves, read from puzzle after the move. Tiles still moving are sent on from
+      * where they are, tiles removed by the move stop. ticks is how long a tween takes. */
+    void start(const Puzzle& puzzle, const Puzzle::move_list& moves, uint32_t ticks);
+    /** Advances every tween by a tick, the tiles that reach their cell are dropped. */
+    void update();
+
+    bool active() const {return !progress.empty();}
+    /** True if a tile is headed to cell and has not landed yet. */
+    bool moving(uint32_t cell) const {return tween_of[cell] != NONE;}
+    /** Leftmost and rightmost columns tiles landed in since the last reset_landed, first > second if none did. */
+    std::pair<uint32_t, uint32_t> landed() const {return {landed_minx, landed_maxx};}
+    void reset_landed() {landed_minx = width; landed_maxx = 0;}
+
+    uint32_t size() const {return progress.size();}
+    /** Position of tween i, alpha ticks (0 to 1) after the last update. */
+    float x(uint32_t i, float alpha) const {return from_x[i] + dx[i] * ease(i, alpha);}
+    float y(uint32_t i, float alpha) const {return from_y[i] + dy[i] * ease(i, alpha);}
+    uint8_t color(uint32_t i) const {return colors[i];}
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    float ease(uint32_t i, float alpha) const
+    {
+        float t = progress[i] + step[i] * alpha;
+        t = t < 1 ? t : 1;
+        return t * t;
+    }
+    void remove(uint32_t i);
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    std::vector<float> from_x;
+    std::vector<float> from_y;
+    std::vector<float> dx;
+    std::vector<float> dy;
+    std::vector<float> progress;
+    std::vector<float> step;
+    std::vector<uint8_t> colors;
+    std::vector<uint32_t> target;
+
+    // Tween moving to each cell, NONE if no tile is headed there.
+    std::vector<uint32_t> tween_of;
+    // start scratch, the tween each move continues (or NONE) looked up before any is changed.
+    std::vector<uint32_t> continued;
+
+    uint32_t landed_minx = 0;
+    uint32_t landed_maxx = 0;
+};
+
+#endif
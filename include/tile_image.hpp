@@ -0,0 +1,32 @@
+#ifndef TILE_IMAGE_HPP
+#define TILE_IMAGE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "board_mesh.hpp"
+#include "puzzle.hpp"
+
+/** The board at a pixel a tile, what the game draws scaled once tiles get too small to draw one by one.
+  *
+  * Pixels are SDL_PIXELFORMAT_RGBA8888 values stored row by row, so the columns a move changed are a rectangle
+  * that goes to a texture with one SDL_UpdateTexture. Empty cells are opaque black. */
+class TileImage
+{
+public:
+    /** Sizes the image, every pixel black. */
+    void reset(uint32_t width, uint32_t height);
+    /** Draws columns [minx, maxx] of puzzle again. */
+    void update(const Puzzle& puzzle, const BoardMesh::palette& colors, uint32_t minx, uint32_t maxx);
+
+    /** First pixel of column x, rows are pitch() bytes apart. */
+    const uint32_t* pixels(uint32_t x = 0) const {return &image[x];}
+    int pitch() const {return width * sizeof(uint32_t);}
+
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> image;
+};
+
+#endif
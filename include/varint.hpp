@@ -0,0 +1,50 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Longest varint of a uint32_t. */
+constexpr size_t VARINT_MAX_BYTES = 5;
+
+/** LEB128, 7 bits per byte with the high bit set on all but the last. */
+inline void write_varint(std::vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(value | 0x80);
+        value >>= 7;
+    }
+    out.push_back(value);
+}
+
+/** Same into out, which has room for VARINT_MAX_BYTES. Returns the number of bytes written. */
+inline size_t write_varint(uint8_t* out, uint32_t value)
+{
+    size_t size = 0;
+    while (value >= 0x80)
+    {
+        out[size++] = value | 0x80;
+        value >>= 7;
+    }
+    out[size++] = value;
+    return size;
+}
+
+/** Reads the varint at offset and moves offset past it, the caller makes sure it is complete.
+  * Never reads more than VARINT_MAX_BYTES, bits past the 32 of a uint32_t are dropped. */
+inline uint32_t read_varint(const uint8_t* in, size_t& offset)
+{
+    uint32_t value = 0;
+    for (uint32_t shift = 0; shift < 7 * VARINT_MAX_BYTES; shift += 7)
+    {
+        uint8_t byte = in[offset++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    return value;
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "SDLGame.hpp"
 
+#include <chrono>
+
 bool SDLGame::Initialize()
 {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK) < 0)
@@ -15,7 +17,7 @@ bool SDLGame::Initialize()
         return false;
     }
 
-    renderer = SDL_CreateRenderer(window, 0, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, 0, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE);
     if (!renderer)
     {
         SDL_Log("SDL_CreateRenderer: %s\n", SDL_GetError());
@@ -31,26 +33,51 @@ bool SDLGame::Initialize()
         }
     }
 
-    if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG)
-    {
-        SDL_Log("IMG_Init: failed to init required png support %s\n", IMG_GetError());
-        return false;
-    }
-
     return true;
 }
 
 void SDLGame::Run()
 {
+    bool idle = false;
+    ResetClock();
     while(true)
     {
+        if (idle)
+        {
+            // The last frame stays on screen, nothing is drawn or presented until there is something new to show.
+            auto start = std::chrono::steady_clock::now();
+            bool woken = SDL_WaitEventTimeout(nullptr, IDLE_WAKEUP_MS) != 0;
+            frame_stats.add_idle(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(),
+                                 woken);
+            if (!woken && !Animating())
+                continue;
+            // Nothing moved while asleep, there are no ticks to catch up on.
+            ResetClock();
+        }
+
+        frame_stats.begin();
         if (!Input()) break;
+        frame_stats.mark(FrameStats::INPUT);
 
-        Update();
+        ticks_since_input += Tick();
+        frame_stats.add_dropped_ticks(dropped_ticks);
+        frame_stats.mark(FrameStats::UPDATE);
 
         Clear(0, 0, 0, 0);
-        Draw();
+        Draw(Interpolation());
+        frame_stats.mark(FrameStats::DRAW);
+
         SDL_RenderPresent(renderer);
+        frame_stats.mark(FrameStats::PRESENT);
+        frame_stats.end();
+
+        if (startup_ms == 0)
+        {
+            startup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launched).count();
+            SDL_Log("First frame presented %.1f ms after launch\n", startup_ms);
+        }
+
+        idle = !Animating();
     }
 }
 
@@ -59,8 +86,11 @@ bool SDLGame::Input()
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
+        ticks_since_input = 0;
         switch (event.type)
         {
+            case SDL_QUIT:
+                return false;
             case SDL_FINGERMOTION:
                 OnTouchMotion(event.tfinger);
                 break;
@@ -76,6 +106,12 @@ bool SDLGame::Input()
             case SDL_JOYBUTTONUP:
                 OnButtonUp(event.jbutton);
                 break;
+            case SDL_JOYAXISMOTION:
+                OnAxisMotion(event.jaxis);
+                break;
+            case SDL_RENDER_TARGETS_RESET:
+                OnRenderTargetsReset();
+                break;
             default:
                 break;
         }
@@ -89,6 +125,5 @@ void SDLGame::Destroy()
     renderer = nullptr;
     if (window) SDL_DestroyWindow(window);
     window = nullptr;
-    IMG_Quit();
     SDL_Quit();
 }
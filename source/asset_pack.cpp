@@ -0,0 +1,111 @@
+#include "asset_pack.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+static const char MAGIC[4] = {'S', 'S', 'A', 'P'};
+
+bool AssetPack::open(const char* filename)
+{
+    close();
+
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+        return false;
+
+    long file_size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    bool ok = file_size >= static_cast<long>(sizeof(Header)) && fseek(file, 0, SEEK_SET) == 0;
+    if (ok)
+    {
+        length = file_size;
+        words.resize((length + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        ok = fread(words.data(), 1, length, file) == length;
+    }
+    fclose(file);
+
+    ok = ok && memcmp(header().magic, MAGIC, sizeof(MAGIC)) == 0 && header().version == VERSION &&
+         header().count <= (length - sizeof(Header)) / sizeof(AssetEntry);
+    for (uint32_t i = 0; ok && i < header().count; i++)
+    {
+        const AssetEntry& entry = entries()[i];
+        uint64_t pixels_end = entry.pixels + uint64_t(entry.width) * entry.height * sizeof(uint32_t);
+        uint64_t glyphs_end = entry.glyphs + uint64_t(entry.glyph_count) * sizeof(AssetGlyph);
+        ok = entry.pixels % sizeof(uint32_t) == 0 && entry.glyphs % sizeof(uint32_t) == 0 && pixels_end <= length &&
+             glyphs_end <= length && memchr(entry.name, 0, sizeof(entry.name)) != nullptr;
+    }
+
+    if (!ok)
+        close();
+    return ok;
+}
+
+void AssetPack::close()
+{
+    words = std::vector<uint32_t>();
+    length = 0;
+}
+
+const AssetEntry* AssetPack::find(std::string_view name) const
+{
+    if (!is_open())
+        return nullptr;
+
+    for (uint32_t i = 0; i < header().count; i++)
+        if (name == entries()[i].name)
+            return &entries()[i];
+    return nullptr;
+}
+
+const uint32_t* AssetPack::pixels(const AssetEntry& entry) const
+{
+    return reinterpret_cast<const uint32_t*>(bytes() + entry.pixels);
+}
+
+const AssetGlyph* AssetPack::glyphs(const AssetEntry& entry) const
+{
+    return reinterpret_cast<const AssetGlyph*>(bytes() + entry.glyphs);
+}
+
+bool AssetPack::write(const char* filename, const std::vector<AssetImage>& images)
+{
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = images.size();
+
+    // Pixels and glyphs follow the index in the order of the images, every part a multiple of 4 bytes long.
+    std::vector<AssetEntry> entries(images.size());
+    uint32_t offset = sizeof(Header) + images.size() * sizeof(AssetEntry);
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        const AssetImage& image = images[i];
+        AssetEntry& entry = entries[i];
+        if (image.name.size() >= sizeof(entry.name) || image.pixels.size() != size_t(image.width) * image.height)
+            return false;
+
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, image.name.data(), image.name.size());
+        entry.width = image.width;
+        entry.height = image.height;
+        entry.pixels = offset;
+        offset += image.pixels.size() * sizeof(uint32_t);
+        entry.glyphs = image.glyphs.empty() ? 0 : offset;
+        entry.glyph_count = image.glyphs.size();
+        entry.first_char = image.first_char;
+        entry.line_height = image.line_height;
+        offset += image.glyphs.size() * sizeof(AssetGlyph);
+    }
+
+    FILE* out = fopen(filename, "wb");
+    if (!out)
+        return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(entries.data(), sizeof(AssetEntry), entries.size(), out) == entries.size();
+    for (const auto& image : images)
+    {
+        ok = ok && fwrite(image.pixels.data(), sizeof(uint32_t), image.pixels.size(), out) == image.pixels.size() &&
+             fwrite(image.glyphs.data(), sizeof(AssetGlyph), image.glyphs.size(), out) == image.glyphs.size();
+    }
+    return fclose(out) == 0 && ok;
+}
@@ -0,0 +1,95 @@
+#include "atlas_font.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+SDL_Texture* create_texture(SDL_Renderer* renderer, const AssetPack& pack, const AssetEntry& entry)
+{
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, entry.width,
+                                             entry.height);
+    if (!texture)
+    {
+        printf("SDL_CreateTexture: %s\n", SDL_GetError());
+        return nullptr;
+    }
+
+    if (SDL_UpdateTexture(texture, nullptr, pack.pixels(entry), entry.width * sizeof(uint32_t)) != 0)
+    {
+        printf("SDL_UpdateTexture: %s\n", SDL_GetError());
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+bool AtlasFont::load(SDL_Renderer* renderer, const AssetPack& pack, std::string_view name)
+{
+    unload();
+    const AssetEntry* entry = pack.find(name);
+    if (!entry || entry->glyph_count == 0)
+        return false;
+
+    texture = create_texture(renderer, pack, *entry);
+    if (!texture)
+        return false;
+    // Drawn smaller than rasterized, as the frame stats are.
+    SDL_SetTextureScaleMode(texture, SDL_ScaleModeLinear);
+
+    glyphs.assign(pack.glyphs(*entry), pack.glyphs(*entry) + entry->glyph_count);
+    first_char = entry->first_char;
+    line_height = entry->line_height;
+    return true;
+}
+
+void AtlasFont::unload()
+{
+    if (texture) SDL_DestroyTexture(texture);
+    texture = nullptr;
+    glyphs.clear();
+}
+
+int AtlasFont::width(std::string_view text) const
+{
+    int width = 0;
+    for (char c : text)
+        if (const AssetGlyph* found = glyph(c))
+            width += found->advance;
+    return width;
+}
+
+int AtlasFont::draw(SDL_Renderer* renderer, int x, int y, std::string_view text, const SDL_Color& color,
+                    float scale) const
+{
+    if (!texture)
+        return 0;
+
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+
+    // The pen moves in unscaled pixels, so scaled text keeps the spacing of the full size text.
+    int pen = 0;
+    for (char c : text)
+    {
+        const AssetGlyph* found = glyph(c);
+        if (!found)
+            continue;
+
+        if (found->width > 0)
+        {
+            SDL_Rect source = {found->x, found->y, found->width, found->height};
+            SDL_FRect rect = {x + (pen + found->left) * scale, y + found->top * scale, found->width * scale,
+                              found->height * scale};
+            SDL_RenderCopyF(renderer, texture, &source, &rect);
+        }
+        pen += found->advance;
+    }
+    return static_cast<int>(std::ceil(pen * scale));
+}
+
+const AssetGlyph* AtlasFont::glyph(char c) const
+{
+    uint32_t index = static_cast<uint8_t>(c) - first_char;
+    return index < glyphs.size() ? &glyphs[index] : nullptr;
+}
@@ -0,0 +1,135 @@
+#include "board_mesh.hpp"
+
+#include <algorithm>
+
+// Pixels left between neighbouring tiles, one unless tiles are too small to spare it.
+static float gap(float tile)
+{
+    return std::min(tile / 16, 1.0f);
+}
+
+void BoardMesh::clear()
+{
+    vertex_list.clear();
+    tinted.clear();
+    tinted_cells.clear();
+    group_cells = 0;
+}
+
+void BoardMesh::set_origin(float x, float y)
+{
+    origin_x = x;
+    origin_y = y;
+}
+
+void BoardMesh::set_bounds(uint32_t minx, uint32_t maxx, uint32_t miny, uint32_t maxy)
+{
+    min_x = minx;
+    max_x = maxx;
+    min_y = miny;
+    max_y = maxy;
+}
+
+void BoardMesh::add_columns(const Puzzle& puzzle, const palette& colors, float tile, uint32_t minx, uint32_t maxx,
+                            const TileAnimation* falling)
+{
+    minx = std::max(minx, min_x);
+    maxx = std::min(maxx, max_x);
+    const uint32_t miny = min_y;
+    const uint32_t maxy = std::min(max_y, puzzle.height - 1);
+    const float inset = gap(tile);
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        // Gravity keeps the tiles of a column at its bottom, the scan stops at the first empty cell above them.
+        for (uint32_t y = maxy + 1; y-- > miny;)
+        {
+            uint8_t c = puzzle.at(x, y);
+            if (c == Puzzle::EMPTY)
+                break;
+            if (falling && falling->moving(puzzle.index(x, y)))
+                continue;
+
+            auto [r, g, b] = colors[c];
+            add_quad(x * tile + inset, y * tile + inset, tile - 2 * inset, r, g, b);
+        }
+    }
+}
+
+void BoardMesh::add_tweens(const TileAnimation& falling, const palette& colors, float tile, float alpha)
+{
+    const float inset = gap(tile);
+    for (uint32_t i = 0; i < falling.size(); i++)
+    {
+        float x = falling.x(i, alpha);
+        float y = falling.y(i, alpha);
+        if (!in_bounds(x, y))
+            continue;
+        auto [r, g, b] = colors[falling.color(i)];
+        add_quad(x * tile + inset, y * tile + inset, tile - 2 * inset, r, g, b);
+    }
+}
+
+void BoardMesh::add_group(const Puzzle& puzzle, float tile, uint32_t cell)
+{
+    const float inset = gap(tile);
+    for (const auto member : puzzle.test(puzzle.cell_x(cell), puzzle.cell_y(cell)))
+    {
+        uint32_t x = puzzle.cell_x(member);
+        uint32_t y = puzzle.cell_y(member);
+        if (in_bounds(x, y))
+        {
+            tinted.push_back(vertex_list.size());
+            tinted_cells.push_back(group_cells);
+            add_quad(x * tile + inset, y * tile + inset, tile - 2 * inset, 255, 255, 255);
+        }
+        group_cells++;
+    }
+}
+
+void BoardMesh::add_marks(const Puzzle& puzzle, float tile, uint32_t cell)
+{
+    for (const auto member : puzzle.test(puzzle.cell_x(cell), puzzle.cell_y(cell)))
+    {
+        uint32_t x = puzzle.cell_x(member);
+        uint32_t y = puzzle.cell_y(member);
+        if (in_bounds(x, y))
+            add_quad(x * tile + tile / 3, y * tile + tile / 3, tile / 3, 255, 255, 255);
+    }
+}
+
+void BoardMesh::set_tints(const ModulationBank& bank)
+{
+    for (uint32_t quad = 0; quad < tinted.size(); quad++)
+    {
+        for (uint32_t i = tinted[quad]; i < tinted[quad] + 4; i++)
+        {
+            vertex_list[i].r = bank.red(tinted_cells[quad]);
+            vertex_list[i].g = bank.green(tinted_cells[quad]);
+            vertex_list[i].b = bank.blue(tinted_cells[quad]);
+        }
+    }
+}
+
+bool BoardMesh::in_bounds(float x, float y) const
+{
+    // Tiles overlapping the bounds at all, a moving tile can be partly in them.
+    return x + 1 > min_x && x < max_x + 1.0f && y + 1 > min_y && y < max_y + 1.0f;
+}
+
+void BoardMesh::add_quad(float x, float y, float size, uint8_t r, uint8_t g, uint8_t b)
+{
+    x += origin_x;
+    y += origin_y;
+    vertex_list.push_back({x, y, r, g, b, 255, 0, 0});
+    vertex_list.push_back({x + size, y, r, g, b, 255, 0, 0});
+    vertex_list.push_back({x, y + size, r, g, b, 255, 0, 0});
+    vertex_list.push_back({x + size, y + size, r, g, b, 255, 0, 0});
+
+    // Indices only depend on the number of quads, they are only ever added to.
+    if (index_list.size() < quads() * 6)
+    {
+        int first = (quads() - 1) * 4;
+        for (int corner : {0, 1, 2, 2, 1, 3})
+            index_list.push_back(first + corner);
+    }
+}
@@ -0,0 +1,82 @@
+#include "camera.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void Camera::reset(uint32_t board_columns, uint32_t board_rows, float width, float height, float largest_tile)
+{
+    columns = std::max(board_columns, 1u);
+    rows = std::max(board_rows, 1u);
+    view_width = width;
+    view_height = height;
+    max_tile = largest_tile;
+    min_tile = std::min(std::min(view_width / columns, view_height / rows), max_tile);
+    tile_size = max_tile;
+    left = (columns - view_width / tile_size) / 2;
+    top = (rows - view_height / tile_size) / 2;
+    clamp();
+    moved = true;
+}
+
+void Camera::pan(float dx, float dy)
+{
+    move(left - dx / tile_size, top - dy / tile_size, tile_size);
+}
+
+void Camera::zoom(float factor, float x, float y)
+{
+    float size = std::min(std::max(tile_size * factor, min_tile), max_tile);
+    move(board_x(x) - x / size, board_y(y) - y / size, size);
+}
+
+void Camera::show(uint32_t x, uint32_t y)
+{
+    move(std::min(std::max(left, x + 1 - view_width / tile_size), static_cast<float>(x)),
+         std::min(std::max(top, y + 1 - view_height / tile_size), static_cast<float>(y)), tile_size);
+}
+
+uint32_t Camera::min_x() const
+{
+    return static_cast<uint32_t>(std::max(left, 0.0f));
+}
+
+uint32_t Camera::max_x() const
+{
+    return std::min(static_cast<uint32_t>(std::max(std::ceil(board_x(view_width)), 1.0f)), columns) - 1;
+}
+
+uint32_t Camera::min_y() const
+{
+    return static_cast<uint32_t>(std::max(top, 0.0f));
+}
+
+uint32_t Camera::max_y() const
+{
+    return std::min(static_cast<uint32_t>(std::max(std::ceil(board_y(view_height)), 1.0f)), rows) - 1;
+}
+
+void Camera::clamp()
+{
+    // Along each axis a board smaller than the view is centered, a larger one covers the view edge to edge.
+    float visible_columns = view_width / tile_size;
+    if (visible_columns >= columns)
+        left = (columns - visible_columns) / 2;
+    else
+        left = std::min(std::max(left, 0.0f), columns - visible_columns);
+
+    float visible_rows = view_height / tile_size;
+    if (visible_rows >= rows)
+        top = (rows - visible_rows) / 2;
+    else
+        top = std::min(std::max(top, 0.0f), rows - visible_rows);
+}
+
+void Camera::move(float new_left, float new_top, float new_tile)
+{
+    float old_left = left, old_top = top, old_tile = tile_size;
+    left = new_left;
+    top = new_top;
+    tile_size = new_tile;
+    clamp();
+    moved = moved || left != old_left || top != old_top || tile_size != old_tile;
+}
@@ -0,0 +1,83 @@
+#include "daily_table.hpp"
+
+#include "random.hpp"
+
+#include <cstring>
+
+static const char MAGIC[4] = {'S', 'S', 'D', 'Y'};
+// Keeps daily seeds apart from the small seeds of the seed catalog.
+static const uint64_t DAILY_SALT = 0x5357495443480001ULL;
+
+bool DailyTable::open(const char* filename)
+{
+    close();
+
+    file = fopen(filename, "rb");
+    if (!file)
+        return false;
+
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void DailyTable::close()
+{
+    if (file)
+        fclose(file);
+    file = nullptr;
+    header = Header();
+}
+
+bool DailyTable::get(uint32_t day, DailyEntry& entry) const
+{
+    if (!file || day < header.first_day || day - header.first_day >= header.count)
+        return false;
+
+    long offset = sizeof(Header) + static_cast<long>(day - header.first_day) * sizeof(DailyEntry);
+    return fseek(file, offset, SEEK_SET) == 0 && fread(&entry, sizeof(entry), 1, file) == 1 && entry.seed == seed(day);
+}
+
+bool DailyTable::write(const char* filename, const std::vector<DailyEntry>& entries, uint32_t first_day, uint32_t width,
+                       uint32_t height, uint8_t colors)
+{
+    FILE* out = fopen(filename, "wb");
+    if (!out)
+        return false;
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.first_day = first_day;
+    header.count = entries.size();
+    header.width = width;
+    header.height = height;
+    header.colors = colors;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(entries.data(), sizeof(DailyEntry), entries.size(), out) == entries.size();
+    return fclose(out) == 0 && ok;
+}
+
+uint32_t DailyTable::day_number(int year, uint32_t month, uint32_t day)
+{
+    // Howard Hinnant's days_from_civil, years start in March so the leap day is the last day of a year.
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t year_of_era = static_cast<uint32_t>(year - era * 400);
+    const uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int>(day_of_era) - 719468;
+}
+
+uint32_t DailyTable::seed(uint32_t day)
+{
+    uint64_t state = DAILY_SALT ^ day;
+    uint32_t value = static_cast<uint32_t>(splitmix64(state));
+    return value ? value : 1;
+}
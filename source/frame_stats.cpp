@@ -0,0 +1,149 @@
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+FrameStats::FrameStats(double refresh_hz) : interval_us(static_cast<uint32_t>(1e6 / refresh_hz)), ring(FRAMES),
+    histogram(BUCKETS, 0), started(steady_clock::now())
+{
+    scratch.reserve(FRAMES);
+}
+
+void FrameStats::begin()
+{
+    current = Frame{};
+    last = steady_clock::now();
+}
+
+void FrameStats::mark(Phase phase)
+{
+    auto now = steady_clock::now();
+    current.phases[phase] += std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+    last = now;
+}
+
+void FrameStats::end()
+{
+    for (uint32_t phase = 0; phase < PHASES; phase++)
+        current.total += current.phases[phase];
+
+    ring[next] = current;
+    next = (next + 1) % FRAMES;
+    count = std::min<size_t>(count + 1, FRAMES);
+
+    histogram[std::min(current.total / BUCKET_US, BUCKETS - 1)]++;
+    total_frames++;
+
+    // With vsync a frame is shown for a whole number of refreshes, rounding absorbs the jitter of the timer.
+    uint32_t refreshes = (current.total + interval_us / 2) / interval_us;
+    if (refreshes > 1)
+        missed += refreshes - 1;
+}
+
+uint32_t FrameStats::percentile(double p) const
+{
+    if (count == 0)
+        return 0;
+
+    scratch.clear();
+    for (size_t i = 0; i < count; i++)
+        scratch.push_back(frame(i).total);
+
+    size_t rank = std::min(static_cast<size_t>(p / 100 * count), count - 1);
+    std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+    return scratch[rank];
+}
+
+uint32_t FrameStats::average(Phase phase) const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+        sum += frame(i).phases[phase];
+    return sum / count;
+}
+
+double FrameStats::average_draw_calls() const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+        sum += frame(i).draw_calls;
+    return double(sum) / count;
+}
+
+uint32_t FrameStats::average_text() const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+        sum += frame(i).text;
+    return sum / count;
+}
+
+void FrameStats::add_idle(uint32_t us, bool woken_by_event)
+{
+    idle_us += us;
+    idle_waits++;
+    if (!woken_by_event)
+        idle_timeouts++;
+}
+
+double FrameStats::idle_fraction() const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - started).count();
+    return elapsed > 0 ? double(idle_us) / elapsed : 0;
+}
+
+double FrameStats::frames_per_minute() const
+{
+    double minutes = std::chrono::duration<double>(steady_clock::now() - started).count() / 60;
+    return minutes > 0 ? total_frames / minutes : 0;
+}
+
+bool FrameStats::write(const char* filename) const
+{
+    FILE* file = fopen(filename, "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "frames %llu\nmissed vsyncs %llu\ndropped ticks %llu\nrefresh us %u\n",
+            static_cast<unsigned long long>(total_frames), static_cast<unsigned long long>(missed),
+            static_cast<unsigned long long>(dropped), interval_us);
+    fprintf(file, "frames per minute %.0f\nidle %.1f%%\nidle waits %llu\nidle timeouts %llu\n\n", frames_per_minute(),
+            100 * idle_fraction(), static_cast<unsigned long long>(idle_waits), static_cast<unsigned long long>(idle_timeouts));
+    // Averaged over the frames still kept, the last ones before exit.
+    for (int phase = 0; phase < PHASES; phase++)
+        fprintf(file, "%s us %u\n", name(static_cast<Phase>(phase)), average(static_cast<Phase>(phase)));
+    fprintf(file, "\n%-12s %12s\n", "frame us", "frames");
+    for (uint32_t bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        if (histogram[bucket] == 0)
+            continue;
+        if (bucket == BUCKETS - 1)
+            fprintf(file, ">=%-10u %12llu\n", bucket * BUCKET_US, static_cast<unsigned long long>(histogram[bucket]));
+        else
+            fprintf(file, "%-12u %12llu\n", bucket * BUCKET_US, static_cast<unsigned long long>(histogram[bucket]));
+    }
+
+    fclose(file);
+    return true;
+}
+
+const char* FrameStats::name(Phase phase)
+{
+    switch (phase)
+    {
+        case INPUT: return "input";
+        case UPDATE: return "update";
+        case DRAW: return "draw";
+        case PRESENT: return "present";
+        default: return "";
+    }
+}
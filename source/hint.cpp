@@ -0,0 +1,261 @@
+#include "hint.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+typedef std::chrono::steady_clock steady_clock;
+
+struct Node
+{
+    uint32_t parent;
+    // Children are stored next to each other, first_child is NOT_EXPANDED until the node's moves are added.
+    uint32_t first_child;
+    uint32_t children;
+    uint32_t cell;
+    uint32_t visits;
+    double reward;
+};
+
+constexpr uint32_t NOT_EXPANDED = UINT32_MAX;
+// Suggestions are published every this many playouts.
+constexpr uint32_t PUBLISH_INTERVAL = 64;
+
+uint32_t score(uint32_t size)
+{
+    return (size - 1) * (size - 1);
+}
+
+// One cell of every group of two or more.
+void list_moves(const Puzzle& puzzle, std::vector<uint32_t>& seen, Puzzle::cell_list& moves)
+{
+    moves.clear();
+    std::fill(seen.begin(), seen.end(), 0);
+    for (uint32_t x = 0; x < puzzle.width; x++)
+    {
+        // Columns are collapsed to the left, the first empty one ends the board.
+        if (puzzle.at(x, puzzle.height - 1) == Puzzle::EMPTY)
+            break;
+
+        for (uint32_t y = puzzle.height; y-- > 0;)
+        {
+            uint32_t group_label = puzzle.label(x, y);
+            if (group_label == Puzzle::NO_GROUP)
+                break;
+            if (seen[group_label] || puzzle.group_size(x, y) < 2)
+                continue;
+            seen[group_label] = 1;
+            moves.push_back(puzzle.index(x, y));
+        }
+    }
+}
+
+}
+
+void HintEngine::start()
+{
+    if (worker.joinable())
+        return;
+
+    quit = false;
+    worker = std::thread([this] {work();});
+}
+
+void HintEngine::stop()
+{
+    if (worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            quit = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    delete pending.exchange(nullptr);
+    searching = false;
+}
+
+void HintEngine::search(const Puzzle& puzzle)
+{
+    // The worker notices the new board between two playouts and drops the old search.
+    Request* request = new Request{puzzle, ++generation};
+    delete pending.exchange(request);
+
+    // A worker still searching sees the board without being woken, which would only hand it the game thread's core.
+    if (waiting)
+    {
+        // The worker holds it from checking pending until it sleeps, so the board cannot slip in between.
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+        }
+        wake.notify_one();
+    }
+}
+
+bool HintEngine::hint(uint32_t& cell) const
+{
+    uint64_t value = answer.load(std::memory_order_acquire);
+    if (generation == 0 || (value >> 32) != generation)
+        return false;
+
+    cell = static_cast<uint32_t>(value);
+    return true;
+}
+
+HintStats HintEngine::stats() const
+{
+    HintStats stats;
+    stats.playouts = playouts;
+    stats.seconds = elapsed_us / 1e6;
+    stats.seconds_to_stable = stable_us / 1e6;
+    stats.playouts_per_second = stats.seconds > 0 ? stats.playouts / stats.seconds : 0;
+    stats.searching = searching;
+    return stats;
+}
+
+void HintEngine::work()
+{
+    while (!quit)
+    {
+        Request* request = pending.exchange(nullptr);
+        if (!request)
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            waiting = true;
+            wake.wait(lock, [this] {return quit || pending.load() != nullptr;});
+            waiting = false;
+            continue;
+        }
+
+        run(*request);
+        delete request;
+    }
+}
+
+void HintEngine::run(const Request& request)
+{
+    const Puzzle& root = request.board;
+    Random random(options.seed, request.generation);
+    auto start = steady_clock::now();
+    auto microseconds = [&start]()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - start).count();
+    };
+
+    playouts = 0;
+    elapsed_us = 0;
+    stable_us = 0;
+    if (!root.has_moves())
+        return;
+    searching = true;
+
+    std::vector<Node> nodes;
+    nodes.reserve(std::min<uint32_t>(options.max_nodes, 4096));
+    nodes.push_back({0, NOT_EXPANDED, 0, 0, 0, 0});
+
+    Puzzle board = root;
+    std::vector<uint32_t> seen(root.width * root.height);
+    Puzzle::cell_list moves;
+    uint32_t best_score = 1;
+    uint32_t best_cell = UINT32_MAX;
+
+    for (uint32_t playout = 1; playout <= options.max_playouts; playout++)
+    {
+        if (quit || pending.load(std::memory_order_relaxed))
+            break;
+
+        // Assigning to a board of the same size copies without allocating.
+        board = root;
+        uint32_t total = 0;
+        uint32_t node = 0;
+
+        // Selection, down the tree by UCT. Unvisited children come first.
+        while (nodes[node].first_child != NOT_EXPANDED && nodes[node].children > 0)
+        {
+            const Node& parent = nodes[node];
+            double log_visits = std::log(std::max(parent.visits, 1u));
+            uint32_t chosen = parent.first_child;
+            double chosen_value = -1;
+            for (uint32_t child = parent.first_child; child < parent.first_child + parent.children; child++)
+            {
+                const Node& candidate = nodes[child];
+                if (candidate.visits == 0)
+                {
+                    chosen = child;
+                    break;
+                }
+                double value = candidate.reward / candidate.visits +
+                               options.exploration * std::sqrt(log_visits / candidate.visits);
+                if (value > chosen_value)
+                {
+                    chosen = child;
+                    chosen_value = value;
+                }
+            }
+
+            node = chosen;
+            uint32_t cell = nodes[node].cell;
+            total += score(board.match(board.cell_x(cell), board.cell_y(cell)));
+        }
+
+        // Expansion, every move of a leaf is added once it has been reached, while the tree has room.
+        if (nodes[node].first_child == NOT_EXPANDED)
+        {
+            list_moves(board, seen, moves);
+            if (nodes.size() + moves.size() <= options.max_nodes)
+            {
+                nodes[node].first_child = nodes.size();
+                nodes[node].children = moves.size();
+                for (const auto cell : moves)
+                    nodes.push_back({node, NOT_EXPANDED, 0, cell, 0, 0});
+            }
+        }
+
+        // Playout, random moves to the end of the game.
+        uint32_t x, y;
+        while (board.random_move(random, x, y))
+            total += score(board.match(x, y));
+        best_score = std::max(best_score, total);
+
+        // Backpropagation.
+        double reward = double(total) / best_score;
+        for (;;)
+        {
+            nodes[node].visits++;
+            nodes[node].reward += reward;
+            if (node == 0)
+                break;
+            node = nodes[node].parent;
+        }
+
+        if (playout % PUBLISH_INTERVAL == 0 || playout == options.max_playouts)
+        {
+            // The most visited move is the one the search trusts most.
+            const Node& top = nodes[0];
+            if (top.first_child == NOT_EXPANDED || top.children == 0)
+                break;
+
+            uint32_t most = top.first_child;
+            for (uint32_t child = top.first_child; child < top.first_child + top.children; child++)
+                if (nodes[child].visits > nodes[most].visits)
+                    most = child;
+
+            uint64_t now = microseconds();
+            if (nodes[most].cell != best_cell)
+            {
+                best_cell = nodes[most].cell;
+                stable_us = now;
+                answer.store(uint64_t(request.generation) << 32 | best_cell, std::memory_order_release);
+            }
+            playouts = playout;
+            elapsed_us = now;
+        }
+    }
+
+    searching = false;
+}
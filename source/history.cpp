@@ -0,0 +1,128 @@
+#include "history.hpp"
+#include "varint.hpp"
+
+#include <algorithm>
+
+uint32_t History::match(Puzzle& puzzle, uint32_t x, uint32_t y, Puzzle::move_list* moves)
+{
+    const auto& group = puzzle.test(x, y);
+    if (group.size() <= 1)
+        return 1;
+
+    cells.assign(group.begin(), group.end());
+    std::sort(cells.begin(), cells.end());
+    color = puzzle.at(x, y);
+
+    // A column is emptied when the group holds its whole stack, from the bottom row up to an empty cell or the top.
+    columns.clear();
+    for (size_t i = 0; i < cells.size();)
+    {
+        uint32_t column = puzzle.cell_x(cells[i]);
+        size_t end = i;
+        while (end < cells.size() && puzzle.cell_x(cells[end]) == column)
+            end++;
+
+        uint32_t top = puzzle.cell_y(cells[i]);
+        if (puzzle.cell_y(cells[end - 1]) == puzzle.height - 1 && end - i == puzzle.height - top &&
+            (top == 0 || puzzle.at(column, top - 1) == Puzzle::EMPTY))
+            columns.push_back(column);
+        i = end;
+    }
+
+    log.resize(position < offsets.size() ? offsets[position] : log.size());
+    offsets.resize(position);
+
+    offsets.push_back(log.size());
+    write(cells.size());
+    log.push_back(color);
+    write(cells[0]);
+    for (size_t i = 1; i < cells.size(); i++)
+        write(cells[i] - cells[i - 1] - 1);
+    write(columns.size());
+    for (size_t i = 0; i < columns.size(); i++)
+        write(i ? columns[i] - columns[i - 1] - 1 : columns[i]);
+    position++;
+
+    trim();
+
+    // Same as Puzzle::match, without flooding the group a second time.
+    for (const auto cell : cells)
+        puzzle.data[cell] = Puzzle::EMPTY;
+    puzzle.compact(cells, moves);
+    return cells.size();
+}
+
+uint32_t History::undo(Puzzle& puzzle)
+{
+    if (!can_undo())
+        return 0;
+
+    decode(offsets[--position]);
+    puzzle.restore(cells, color, columns);
+    return cells.size();
+}
+
+uint32_t History::redo(Puzzle& puzzle, Puzzle::move_list* moves)
+{
+    if (!can_redo())
+        return 0;
+
+    decode(offsets[position++]);
+    return puzzle.match(puzzle.cell_x(cells[0]), puzzle.cell_y(cells[0]), moves);
+}
+
+size_t History::memory() const
+{
+    return log.capacity() + (offsets.capacity() + cells.capacity() + columns.capacity()) * sizeof(uint32_t);
+}
+
+void History::clear()
+{
+    log.clear();
+    offsets.clear();
+    position = 0;
+}
+
+void History::write(uint32_t value)
+{
+    write_varint(log, value);
+}
+
+uint32_t History::read(size_t& offset) const
+{
+    return read_varint(log.data(), offset);
+}
+
+void History::decode(size_t offset)
+{
+    cells.resize(read(offset));
+    color = log[offset++];
+    for (size_t i = 0; i < cells.size(); i++)
+        cells[i] = read(offset) + (i ? cells[i - 1] + 1 : 0);
+
+    columns.resize(read(offset));
+    for (size_t i = 0; i < columns.size(); i++)
+        columns[i] = read(offset) + (i ? columns[i - 1] + 1 : 0);
+}
+
+void History::trim()
+{
+    auto bytes = [this](size_t first) {return log.size() - offsets[first] + (offsets.size() - first) * sizeof(uint32_t);};
+    if (!limit || bytes(0) <= limit)
+        return;
+
+    // Forget the oldest moves down to half the limit so trimming happens once in a while rather than every move.
+    // Moves that can still be redone are kept.
+    size_t drop = 0;
+    while (drop < position && bytes(drop) > limit / 2)
+        drop++;
+    if (drop == 0)
+        return;
+
+    size_t start = drop < offsets.size() ? offsets[drop] : log.size();
+    log.erase(log.begin(), log.begin() + start);
+    offsets.erase(offsets.begin(), offsets.begin() + drop);
+    for (auto& offset : offsets)
+        offset -= start;
+    position -= drop;
+}
@@ -1,46 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <memory>
 
 #include <switch.h>
 #include "SDLGame.hpp"
-#include "NFont.h"
-#include "SDL_FontCache.h"
 
 #include "puzzle.hpp"
-#include "color_modulation.hpp"
+#include "asset_pack.hpp"
+#include "atlas_font.hpp"
+#include "board_mesh.hpp"
+#include "camera.hpp"
+#include "daily_table.hpp"
+#include "frame_stats.hpp"
+#include "hint.hpp"
+#include "history.hpp"
+#include "modulation_bank.hpp"
+#include "replay.hpp"
+#include "score_store.hpp"
+#include "seed_catalog.hpp"
+#include "text_cache.hpp"
+#include "tile_animation.hpp"
+#include "tile_image.hpp"
 
 constexpr uint32_t GAME_WIDTH = SCREEN_WIDTH;
 constexpr uint32_t GAME_HEIGHT = SCREEN_HEIGHT - 120;
+constexpr uint32_t BOARD_WIDTH = 16;
+constexpr uint32_t BOARD_HEIGHT = 8;
+constexpr uint8_t BOARD_COLORS = 4;
+// Bytes of undo kept, a 16x8 game takes about half a kilobyte so only boards far larger forget their first moves.
+constexpr size_t HISTORY_BYTES = 64 * 1024;
+// The cursor and the glyphs of the font, decoded ahead by tools/asset_pack.
+constexpr const char* ASSET_PACK = "romfs:/assets.pack";
+// The game being played is always recorded here, see tools/replay.
+constexpr const char* REPLAY_FILE = "sdmc:/switch/switch-shot.replay";
+// High scores, written by a thread of their own. The journal holds the games since the last snapshot.
+constexpr const char* SCORES_FILE = "sdmc:/switch/switch-shot-scores.bin";
+constexpr const char* SCORES_JOURNAL = "sdmc:/switch/switch-shot-scores.journal";
+// Each difficulty keeps its own scores, the daily challenge those after hard.
+constexpr uint8_t DAILY_SCORES = SeedCatalog::UNSOLVED;
+// Tiles are this size zoomed in all the way, zooming out stops once the whole board is in view.
+constexpr uint32_t TILE_SIZE = 120;
+// Largest board, in pixels at TILE_SIZE, kept drawn in a texture. Larger boards draw the tiles in view every frame.
+constexpr int MAX_BOARD_TEXTURE = 4096;
+// Tiles smaller than this many pixels are drawn from a pixel a tile image scaled up, not one by one.
+constexpr float LOD_TILE = 8;
+// Game ticks a second, every duration in ticks below assumes this rate. A frame late by more than
+// MAX_TICKS_PER_FRAME ticks slows the game down instead of catching up.
+constexpr uint32_t TICK_RATE = 60;
+constexpr uint32_t MAX_TICKS_PER_FRAME = 4;
+// Pixels a tick the right stick pans the board when pushed all the way, it does nothing inside the dead zone.
+constexpr float PAN_SPEED = 24;
+constexpr int STICK_DEAD_ZONE = 8000;
+constexpr uint8_t PAN_AXIS_X = 2;
+constexpr uint8_t PAN_AXIS_Y = 3;
+// The selected group pulses for this many ticks after the last input, then holds its color so the game can idle.
+constexpr uint32_t SELECTION_PULSE_TICKS = 600;
+// Each tile of the selected group pulses once every PULSE_TICKS, a tile further right or down is PULSE_RIPPLE of a
+// cycle behind the one before it so a wave runs through the group.
+constexpr uint32_t PULSE_TICKS = 118;
+constexpr float PULSE_RIPPLE = 0.1f;
+// Ticks tiles take to fall or slide to the cell a match sent them to.
+constexpr uint32_t FALL_TICKS = 12;
+// Histogram of every frame time, written on exit.
+constexpr const char* FRAME_STATS_FILE = "sdmc:/switch/switch-shot-frames.txt";
+
+// Days since 1970-01-01 on the console's calendar, on UTC's if the console has no local time.
+static uint32_t Today()
+{
+    time_t now = time(NULL);
+    tm* date = localtime(&now);
+    if (!date)
+        return now / (24 * 60 * 60);
+    return DailyTable::day_number(date->tm_year + 1900, date->tm_mon + 1, date->tm_mday);
+}
 
 class SwitchShot : public SDLGame
 {
 public:
-    SwitchShot() : SDLGame("SwitchShot!") {}
+    SwitchShot() : SDLGame("SwitchShot!", TICK_RATE, MAX_TICKS_PER_FRAME) {}
 
     bool Initialize() override;
     void New(time_t seeded_game = 0) override;
     void Update() override;
-    void Draw() override;
+    void Draw(float alpha) override;
     void Destroy() override;
 
 private:
     void OnTouchMotion(const SDL_TouchFingerEvent& event) override;
     void OnTouchDown(const SDL_TouchFingerEvent& event) override;
+    void OnTouchUp(const SDL_TouchFingerEvent& event) override;
     void OnButtonDown(const SDL_JoyButtonEvent& event) override;
+    void OnAxisMotion(const SDL_JoyAxisEvent& event) override;
+    void OnRenderTargetsReset() override;
+    bool Animating() override;
 
     std::pair<uint32_t, uint32_t> GetCoords(float x, float y) const;
     void DoMatch(uint32_t tile_x, uint32_t tile_y);
     void DoSelectSet(uint32_t tile_x, uint32_t tile_y);
+    void DoUndo();
+    void DoRedo();
+    void SaveScore();
+    void BoardChanged();
+    void DrawBoard(float alpha);
+    void DrawHud();
+    void DrawFrameStats();
 
     SDL_Texture* cursor = nullptr;
-    std::unique_ptr<NFont> font;
+    AtlasFont font;
+    // Score and hint text, only laid out again when a label changes.
+    std::unique_ptr<TextCache> hud;
 
     std::unique_ptr<Puzzle> puzzle;
+    History history{HISTORY_BYTES};
+    ReplayWriter recorder;
     uint32_t score;
 
-    std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> colors;
+    // Searches every board as it comes up, Update only picks up its latest suggestion.
+    HintEngine hints;
+    bool show_hint = false;
+    uint32_t hint_group = Puzzle::NO_GROUP;
+    uint32_t hint_cell = 0;
+
+    // Seeds known to deal a board that can be cleared, see tools/seed_gen.
+    SeedCatalog catalog;
+    // Draws the catalog seeds. Seeded from the clock once, Game::random is reseeded by every game.
+    Random picks;
+    uint8_t difficulty = SeedCatalog::EASY;
+    std::string difficulty_label;
+    // Y steps past hard into the board of the day, its par worked out ahead by tools/daily_gen. 0 if not known.
+    DailyTable daily;
+    bool daily_mode = false;
+    uint32_t par = 0;
+
+    // A game is saved when it runs out of moves, and again if an undo brings moves back and it finishes anew.
+    ScoreStore scores;
+    bool score_saved = false;
+
+    BoardMesh::palette colors;
     std::pair<uint32_t, uint32_t> current_tile;
-    Puzzle::point_set points;
-    ColorModulation modulation;
+    uint32_t selected_group = Puzzle::NO_GROUP;
+    // The selected group pulses between these, a modulator for each of its tiles.
+    uint32_t pulse_min;
+    uint32_t pulse_max;
+    ModulationBank pulses;
+    bool show_frame_stats = false;
+
+    // The tiles are kept drawn in board_texture, only the columns a move changed are drawn again.
+    // The selected and hinted groups are drawn over it from overlay, rebuilt when the board, selection or hint changed.
+    SDL_Texture* board_texture = nullptr;
+    bool board_reset = true;
+    BoardMesh tiles;
+    BoardMesh overlay;
+    bool overlay_dirty = true;
+
+    // Tiles on their way to the cell the last moves sent them to, left out of board_texture until they land.
+    TileAnimation falling;
+    Puzzle::move_list moves;
+    BoardMesh moving;
+
+    // The part of the board in view. The right stick pans it and a pinch zooms it.
+    // Zoomed out past LOD_TILE the board is drawn from lod_texture, kept as tile_image.
+    Camera camera;
+    float pan_x = 0;
+    float pan_y = 0;
+    TileImage tile_image;
+    SDL_Texture* lod_texture = nullptr;
+    bool lod_reset = true;
+
+    // The first two fingers on the screen, two of them pinch and pan instead of selecting.
+    // A finger pressed on the selected group matches it when lifted on the same group.
+    struct Finger
+    {
+        SDL_FingerID id;
+        float x, y;
+    };
+    Finger fingers[2];
+    uint32_t tracked_fingers = 0;
+    uint32_t touches = 0;
+    bool pinching = false;
+    bool tap_matches = false;
+    std::pair<uint32_t, uint32_t> pressed;
 };
 
 bool SwitchShot::Initialize()
@@ -50,24 +190,41 @@ bool SwitchShot::Initialize()
 
     romfsInit();
 
-    SDL_Surface* surface = IMG_Load("romfs:/graphics/cursor.png");
-    if (!surface)
+    // Freed once its images are textures.
+    AssetPack assets;
+    if (!assets.open(ASSET_PACK))
     {
-         printf("IMG_Load: %s\n", IMG_GetError());
-         return false;
+        printf("Could not read %s\n", ASSET_PACK);
+        return false;
     }
 
-    cursor = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!cursor)
+    const AssetEntry* cursor_image = assets.find("cursor");
+    cursor = cursor_image ? create_texture(renderer, assets, *cursor_image) : nullptr;
+    if (!cursor || !font.load(renderer, assets, "font"))
     {
-        printf("CreateTextureFromSurface failed: %s\n", SDL_GetError());
-        SDL_FreeSurface(surface);
+        printf("%s has no usable cursor or font\n", ASSET_PACK);
         return false;
     }
-    SDL_FreeSurface(surface);
+    hud.reset(new TextCache(renderer, font, {128, 128, 255, 255}));
+
+    if (!catalog.open("romfs:/seeds.bin") || !catalog.matches(BOARD_WIDTH, BOARD_HEIGHT, BOARD_COLORS))
+    {
+        printf("No usable seed catalog, new games use the clock as their seed\n");
+        catalog.close();
+    }
+
+    if (!daily.open("romfs:/daily.bin") || !daily.matches(BOARD_WIDTH, BOARD_HEIGHT, BOARD_COLORS))
+    {
+        printf("No usable daily table, daily challenges have no par\n");
+        daily.close();
+    }
+
+    if (!scores.open(SCORES_FILE, SCORES_JOURNAL))
+        printf("No saved scores in %s, starting over\n", SCORES_FILE);
 
-    font.reset(new NFont(renderer, "romfs:/fonts/FreeSans.ttf", 60));
+    hints.start();
 
+    picks.seed(time(NULL));
     New();
 
     return true;
@@ -75,56 +232,362 @@ bool SwitchShot::Initialize()
 
 void SwitchShot::New(time_t seeded_game)
 {
+    if (seeded_game == 0 && daily_mode)
+    {
+        uint32_t day = Today();
+        seeded_game = DailyTable::seed(day);
+
+        DailyEntry entry;
+        par = daily.is_open() && daily.get(day, entry) ? entry.par : 0;
+    }
+    else if (seeded_game == 0 && catalog.size(difficulty) > 0)
+    {
+        SeedEntry entry;
+        if (catalog.pick(difficulty, picks, entry))
+            seeded_game = entry.seed;
+    }
+
     SDLGame::New(seeded_game);
 
     colors.clear();
-    for (int i = 0; i < 4; i++)
-        colors.push_back({randomInt(48, 255 - 48), randomInt(48, 255 - 48), randomInt(48, 255 - 48)});
+    for (uint8_t i = 0; i < BOARD_COLORS; i++)
+        colors.push_back({random.range(48, 255 - 48), random.range(48, 255 - 48), random.range(48, 255 - 48)});
 
-    puzzle.reset(new Puzzle(16, 8, 4));
+    puzzle.reset(new Puzzle(BOARD_WIDTH, BOARD_HEIGHT, BOARD_COLORS, seed));
+    falling.reset(puzzle->width, puzzle->height);
+    camera.reset(puzzle->width, puzzle->height, GAME_WIDTH, GAME_HEIGHT, TILE_SIZE);
+    tile_image.reset(puzzle->width, puzzle->height);
+    history.clear();
+    if (!recorder.open(REPLAY_FILE, seed, *puzzle))
+        printf("Could not open %s, this game will not be recorded\n", REPLAY_FILE);
 
     current_tile = {puzzle->width / 2, puzzle->height / 2};
+    selected_group = Puzzle::NO_GROUP;
 
     score = 0;
+    score_saved = false;
+    if (daily_mode)
+        difficulty_label = par ? " (daily, par " + std::to_string(par) + ")" : " (daily)";
+    else
+        difficulty_label = catalog.is_open() ? std::string(" (") + SeedCatalog::name(difficulty) + ")" : "";
+    BoardChanged();
 }
 
 void SwitchShot::Update()
 {
-    modulation.update();
+    pulses.update();
+    falling.update();
+    if (pan_x != 0 || pan_y != 0)
+        camera.pan(-pan_x * PAN_SPEED, -pan_y * PAN_SPEED);
+
+    uint32_t cell = 0;
+    uint32_t group = show_hint && hints.hint(cell) ? puzzle->label(puzzle->cell_x(cell), puzzle->cell_y(cell)) : Puzzle::NO_GROUP;
+    if (group != hint_group)
+    {
+        hint_group = group;
+        hint_cell = cell;
+        overlay_dirty = true;
+    }
+}
+
+void SwitchShot::Draw(float alpha)
+{
+    // The board and cursor stay in the game area, however far they are panned.
+    const SDL_Rect game_area = {0, 0, GAME_WIDTH, GAME_HEIGHT};
+    SDL_RenderSetClipRect(renderer, &game_area);
+    DrawBoard(alpha);
+
+    if (current_tile != std::make_pair(-1U, -1U))
+    {
+        SDL_FRect rect = {camera.screen_x(current_tile.first), camera.screen_y(current_tile.second), camera.tile(),
+                          camera.tile()};
+        SDL_RenderCopyF(renderer, cursor, nullptr, &rect);
+        frame_stats.count_draw_calls();
+    }
+    SDL_RenderSetClipRect(renderer, nullptr);
+
+    DrawHud();
+
+    if (show_frame_stats)
+        DrawFrameStats();
 }
 
-void SwitchShot::Draw()
+void SwitchShot::DrawBoard(float alpha)
 {
-    for (uint32_t y = 0; y < puzzle->height; y++)
+    static_assert(sizeof(MeshVertex) == sizeof(SDL_Vertex), "MeshVertex must match SDL_Vertex");
+    auto draw_mesh = [this](const BoardMesh& mesh)
+    {
+        if (mesh.quads() == 0)
+            return;
+        SDL_RenderGeometry(renderer, nullptr, reinterpret_cast<const SDL_Vertex*>(mesh.vertices().data()),
+                           mesh.vertices().size(), mesh.indices().data(), mesh.index_count());
+        frame_stats.count_draw_calls();
+    };
+
+    const int board_width = puzzle->width * TILE_SIZE;
+    const int board_height = puzzle->height * TILE_SIZE;
+    if (!board_texture && board_width <= MAX_BOARD_TEXTURE && board_height <= MAX_BOARD_TEXTURE)
+    {
+        board_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, board_width, board_height);
+        if (!board_texture)
+            printf("SDL_CreateTexture: %s\n", SDL_GetError());
+        board_reset = true;
+    }
+
+    // Only made once the board is zoomed out that far.
+    const float tile = camera.tile();
+    if (!lod_texture && tile < LOD_TILE)
     {
-        for (uint32_t x = 0; x < puzzle->width; x++)
+        lod_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, puzzle->width, puzzle->height);
+        if (lod_texture)
+            SDL_SetTextureScaleMode(lod_texture, SDL_ScaleModeNearest);
+        else
+            printf("SDL_CreateTexture: %s\n", SDL_GetError());
+        lod_reset = true;
+    }
+
+    // Columns the last move changed, and those where tiles landed.
+    auto [minx, maxx] = puzzle->changes();
+    minx = std::min(minx, falling.landed().first);
+    maxx = std::max(maxx, falling.landed().second);
+    if (board_reset)
+    {
+        minx = 0;
+        maxx = puzzle->width - 1;
+    }
+
+    if (board_texture && minx <= maxx)
+    {
+        SDL_SetRenderTarget(renderer, board_texture);
+        SDL_Rect columns = {static_cast<int>(minx * TILE_SIZE), 0, static_cast<int>((maxx - minx + 1) * TILE_SIZE), board_height};
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &columns);
+        frame_stats.count_draw_calls();
+
+        tiles.clear();
+        tiles.set_origin(0, 0);
+        tiles.set_bounds(0, puzzle->width - 1, 0, puzzle->height - 1);
+        tiles.add_columns(*puzzle, colors, TILE_SIZE, minx, maxx, &falling);
+        draw_mesh(tiles);
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    // The image shows tiles where they land, it is only drawn too small for them to be seen falling.
+    if (minx <= maxx)
+        tile_image.update(*puzzle, colors, minx, maxx);
+    if (lod_texture && lod_reset)
+    {
+        minx = 0;
+        maxx = puzzle->width - 1;
+    }
+    if (lod_texture && minx <= maxx)
+    {
+        SDL_Rect columns = {static_cast<int>(minx), 0, static_cast<int>(maxx - minx + 1), static_cast<int>(puzzle->height)};
+        SDL_UpdateTexture(lod_texture, &columns, tile_image.pixels(minx), tile_image.pitch());
+    }
+    puzzle->reset_changes();
+    falling.reset_landed();
+    board_reset = false;
+    lod_reset = false;
+
+    // Only the tiles in view are drawn.
+    const uint32_t view_minx = camera.min_x(), view_maxx = camera.max_x();
+    const uint32_t view_miny = camera.min_y(), view_maxy = camera.max_y();
+    const SDL_FRect view = {camera.screen_x(view_minx), camera.screen_y(view_miny), (view_maxx - view_minx + 1) * tile,
+                            (view_maxy - view_miny + 1) * tile};
+    if (lod_texture && tile < LOD_TILE)
+    {
+        SDL_Rect source = {static_cast<int>(view_minx), static_cast<int>(view_miny), static_cast<int>(view_maxx - view_minx + 1),
+                           static_cast<int>(view_maxy - view_miny + 1)};
+        SDL_RenderCopyF(renderer, lod_texture, &source, &view);
+        frame_stats.count_draw_calls();
+    }
+    else if (board_texture)
+    {
+        SDL_Rect source = {static_cast<int>(view_minx * TILE_SIZE), static_cast<int>(view_miny * TILE_SIZE),
+                           static_cast<int>((view_maxx - view_minx + 1) * TILE_SIZE),
+                           static_cast<int>((view_maxy - view_miny + 1) * TILE_SIZE)};
+        SDL_RenderCopyF(renderer, board_texture, &source, &view);
+        frame_stats.count_draw_calls();
+
+        moving.clear();
+        moving.set_origin(camera.screen_x(0), camera.screen_y(0));
+        moving.set_bounds(view_minx, view_maxx, view_miny, view_maxy);
+        moving.add_tweens(falling, colors, tile, alpha);
+        draw_mesh(moving);
+    }
+    else
+    {
+        // Without a render target every tile in view is drawn every frame.
+        tiles.clear();
+        tiles.set_origin(camera.screen_x(0), camera.screen_y(0));
+        tiles.set_bounds(view_minx, view_maxx, view_miny, view_maxy);
+        tiles.add_columns(*puzzle, colors, tile, view_minx, view_maxx, &falling);
+        tiles.add_tweens(falling, colors, tile, alpha);
+        draw_mesh(tiles);
+    }
+
+    if (camera.changed())
+    {
+        overlay_dirty = true;
+        camera.reset_changes();
+    }
+
+    if (overlay_dirty)
+    {
+        overlay.clear();
+        overlay.set_origin(camera.screen_x(0), camera.screen_y(0));
+        overlay.set_bounds(view_minx, view_maxx, view_miny, view_maxy);
+        pulses.clear();
+        if (selected_group != Puzzle::NO_GROUP && puzzle->label(current_tile.first, current_tile.second) == selected_group)
         {
-            uint8_t c = puzzle->at(x, y);
-            if (c == Puzzle::EMPTY) continue;
+            overlay.add_group(*puzzle, tile, puzzle->index(current_tile.first, current_tile.second));
+            // Same cells in the same order as add_group, modulator i tints quad i.
+            for (const auto member : puzzle->test(current_tile.first, current_tile.second))
+                pulses.add(pulse_min, pulse_max, PULSE_TICKS, -PULSE_RIPPLE * (puzzle->cell_x(member) + puzzle->cell_y(member)));
+        }
+        if (hint_group != Puzzle::NO_GROUP)
+            overlay.add_marks(*puzzle, tile, hint_cell);
+        overlay_dirty = false;
+    }
+    pulses.evaluate(alpha);
+    overlay.set_tints(pulses);
+    draw_mesh(overlay);
+}
 
-            auto [r, g, b] = colors[c];
+void SwitchShot::DrawHud()
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t calls = hud->draw_calls();
+    const int top = BOARD_HEIGHT * TILE_SIZE;
+
+    int x = hud->draw(0, top, "Score: ");
+    x += hud->draw_number(x, top, score);
+    if (!difficulty_label.empty())
+        x += hud->draw(x, top, difficulty_label);
+    if (daily_mode && par && !puzzle->has_moves())
+        x += hud->draw(x, top, score > par ? " beat par!" : score == par ? " made par" : " under par");
+    uint32_t best = scores.scores().best(daily_mode ? DAILY_SCORES : difficulty);
+    if (best > 0)
+    {
+        x += hud->draw(x, top, "  Best: ");
+        hud->draw_number(x, top, best);
+    }
 
-            if (points.find({x, y}) != points.end())
-                SDL_SetRenderDrawColor(renderer, modulation.red(), modulation.green(), modulation.blue(), 255);
-            else
-                SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+    if (show_hint)
+    {
+        HintStats stats = hints.stats();
+        x = GAME_WIDTH / 2;
+        x += hud->draw(x, top, "Hint: ");
+        x += hud->draw_number(x, top, static_cast<uint32_t>(stats.playouts_per_second / 1000));
+        x += hud->draw(x, top, "k playouts/s, stable after ");
+        x += hud->draw_number(x, top, static_cast<uint32_t>(stats.seconds_to_stable * 1000));
+        hud->draw(x, top, " ms");
+    }
+
+    frame_stats.count_draw_calls(hud->draw_calls() - calls);
+    frame_stats.add_text(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
 
-            SDL_Rect rect = {static_cast<int>(x) * 120 + 1, static_cast<int>(y) * 120 + 1, 118, 118};
-            SDL_RenderFillRect(renderer, &rect);
+void SwitchShot::DrawFrameStats()
+{
+    // One bar per kept frame, its phases stacked from the bottom, scaled so the graph spans two refreshes.
+    constexpr int BAR = 2;
+    constexpr int GRAPH_HEIGHT = 240;
+    const int left = SCREEN_WIDTH - BAR * FrameStats::FRAMES - 20;
+    const int top = 20;
+    const uint32_t span = 2 * frame_stats.interval();
+    static const uint8_t phase_colors[FrameStats::PHASES][3] = {{64, 128, 255}, {64, 224, 64}, {255, 208, 64}, {255, 64, 64}};
+
+    SDL_Rect panel = {left - 10, top - 10, BAR * static_cast<int>(FrameStats::FRAMES) + 20, GRAPH_HEIGHT + 260};
+    SDL_SetRenderDrawColor(renderer, 16, 16, 16, 255);
+    SDL_RenderFillRect(renderer, &panel);
+
+    for (size_t i = 0; i < frame_stats.size(); i++)
+    {
+        const auto& frame = frame_stats.frame(i);
+        int bottom = top + GRAPH_HEIGHT;
+        for (int phase = 0; phase < FrameStats::PHASES && bottom > top; phase++)
+        {
+            int height = std::min<int>(frame.phases[phase] * GRAPH_HEIGHT / span, bottom - top);
+            SDL_Rect bar = {left + static_cast<int>(i) * BAR, bottom - height, BAR, height};
+            SDL_SetRenderDrawColor(renderer, phase_colors[phase][0], phase_colors[phase][1], phase_colors[phase][2], 255);
+            SDL_RenderFillRect(renderer, &bar);
+            bottom -= height;
         }
     }
 
-    if (current_tile != std::make_pair(-1U, -1U))
+    // The refresh interval, bars above it missed a vsync.
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawLine(renderer, left, top + GRAPH_HEIGHT / 2, left + BAR * FrameStats::FRAMES, top + GRAPH_HEIGHT / 2);
+
+    const SDL_Color white = {255, 255, 255, 255};
+    const float scale = 0.5f;
+    char line[96];
+    snprintf(line, sizeof(line), "ms  p50 %.1f  p95 %.1f  p99 %.1f  max %.1f", frame_stats.percentile(50) / 1000.0,
+             frame_stats.percentile(95) / 1000.0, frame_stats.percentile(99) / 1000.0,
+             frame_stats.percentile(100) / 1000.0);
+    font.draw(renderer, left, top + GRAPH_HEIGHT + 10, line, white, scale);
+    // Each phase in the color of its part of the bars.
+    int x = left;
+    for (int phase = 0; phase < FrameStats::PHASES; phase++)
     {
-        SDL_Rect rect = {static_cast<int>(current_tile.first) * 120, static_cast<int>(current_tile.second) * 120, 120, 120};
-        SDL_RenderCopy(renderer, cursor, nullptr, &rect);
+        const auto which = static_cast<FrameStats::Phase>(phase);
+        const SDL_Color color = {phase_colors[phase][0], phase_colors[phase][1], phase_colors[phase][2], 255};
+        snprintf(line, sizeof(line), "%s %.1f  ", FrameStats::name(which), frame_stats.average(which) / 1000.0);
+        x += font.draw(renderer, x, top + GRAPH_HEIGHT + 50, line, color, scale);
     }
+    snprintf(line, sizeof(line), "missed vsyncs %llu of %llu frames, %.0f draw calls",
+             static_cast<unsigned long long>(frame_stats.missed_vsyncs()),
+             static_cast<unsigned long long>(frame_stats.frames()), frame_stats.average_draw_calls());
+    font.draw(renderer, left, top + GRAPH_HEIGHT + 90, line, white, scale);
+    snprintf(line, sizeof(line), "hud text %.3f ms, %llu strings rendered", frame_stats.average_text() / 1000.0,
+             static_cast<unsigned long long>(hud->renders()));
+    font.draw(renderer, left, top + GRAPH_HEIGHT + 130, line, white, scale);
+    snprintf(line, sizeof(line), "idle %.0f%%, %.0f frames/min since start", 100 * frame_stats.idle_fraction(),
+             frame_stats.frames_per_minute());
+    font.draw(renderer, left, top + GRAPH_HEIGHT + 170, line, white, scale);
+    snprintf(line, sizeof(line), "first frame %.0f ms after launch, %llu ticks dropped", startup_ms,
+             static_cast<unsigned long long>(frame_stats.dropped_ticks()));
+    font.draw(renderer, left, top + GRAPH_HEIGHT + 210, line, white, scale);
+}
 
-    font->draw(renderer, 0, 8 * 120, NFont::Color(128, 128, 255), "Score: %d", score);
+void SwitchShot::OnRenderTargetsReset()
+{
+    board_reset = true;
+    if (hud) hud->clear();
+}
+
+bool SwitchShot::Animating()
+{
+    if (overlay_dirty || show_frame_stats || falling.active() || pan_x != 0 || pan_y != 0)
+        return true;
+    if (selected_group != Puzzle::NO_GROUP && ticks_since_input < SELECTION_PULSE_TICKS)
+        return true;
+    if (!show_hint)
+        return false;
+
+    // A running search changes the hint and its stats. Checked first, a finished search published its last hint already.
+    if (hints.stats().searching)
+        return true;
+    uint32_t cell = 0;
+    uint32_t group = hints.hint(cell) ? puzzle->label(puzzle->cell_x(cell), puzzle->cell_y(cell)) : Puzzle::NO_GROUP;
+    return group != hint_group;
 }
 
 void SwitchShot::Destroy()
 {
+    hints.stop();
+    scores.close();
+    recorder.close();
+    if (board_texture) SDL_DestroyTexture(board_texture);
+    board_texture = nullptr;
+    if (lod_texture) SDL_DestroyTexture(lod_texture);
+    lod_texture = nullptr;
+    if (!frame_stats.write(FRAME_STATS_FILE))
+        printf("Could not write %s\n", FRAME_STATS_FILE);
+    hud.reset();
+    font.unload();
     if (cursor) SDL_DestroyTexture(cursor);
     cursor = nullptr;
     SDLGame::Destroy();
@@ -133,26 +596,88 @@ void SwitchShot::Destroy()
 
 std::pair<uint32_t, uint32_t> SwitchShot::GetCoords(float x, float y) const
 {
-    uint32_t sx = static_cast<uint32_t>(x * SCREEN_WIDTH);
-    uint32_t sy = static_cast<uint32_t>(y * SCREEN_HEIGHT);
-
+    float sx = x * SCREEN_WIDTH;
+    float sy = y * SCREEN_HEIGHT;
     if (sx > GAME_WIDTH || sy > GAME_HEIGHT)
         return {-1, -1};
 
-    return {std::max(std::min(sx / 120, puzzle->width - 1), 0U),
-            std::max(std::min(sy / 120, puzzle->height - 1), 0U)};
+    float board_x = camera.board_x(sx);
+    float board_y = camera.board_y(sy);
+    if (board_x < 0 || board_y < 0 || board_x >= puzzle->width || board_y >= puzzle->height)
+        return {-1, -1};
+
+    return {static_cast<uint32_t>(board_x), static_cast<uint32_t>(board_y)};
 }
 
 void SwitchShot::OnTouchDown(const SDL_TouchFingerEvent& event)
 {
+    if (tracked_fingers < 2)
+        fingers[tracked_fingers++] = {event.fingerId, event.x, event.y};
+    if (++touches > 1)
+    {
+        pinching = true;
+        return;
+    }
+    pinching = false;
+
+    // Pressing the selected group matches it on release, pressing anything else selects it right away.
     auto [tile_x, tile_y] = GetCoords(event.x, event.y);
-    DoMatch(tile_x, tile_y);
+    pressed = {tile_x, tile_y};
+    tap_matches = tile_x != -1U && selected_group != Puzzle::NO_GROUP && puzzle->label(tile_x, tile_y) == selected_group;
+    if (!tap_matches)
+        DoMatch(tile_x, tile_y);
 }
 
-void SwitchShot::OnTouchMotion(const SDL_TouchFingerEvent& event)
+void SwitchShot::OnTouchUp(const SDL_TouchFingerEvent& event)
 {
+    for (uint32_t i = 0; i < tracked_fingers; i++)
+    {
+        if (fingers[i].id == event.fingerId)
+        {
+            fingers[i] = fingers[--tracked_fingers];
+            break;
+        }
+    }
+    touches = touches > 0 ? touches - 1 : 0;
+
+    if (pinching || !tap_matches || touches > 0)
+        return;
+    tap_matches = false;
+
     auto [tile_x, tile_y] = GetCoords(event.x, event.y);
-    DoSelectSet(tile_x, tile_y);
+    if (tile_x != -1U && puzzle->label(tile_x, tile_y) == puzzle->label(pressed.first, pressed.second))
+        DoMatch(tile_x, tile_y);
+}
+
+void SwitchShot::OnTouchMotion(const SDL_TouchFingerEvent& event)
+{
+    if (!pinching)
+    {
+        auto [tile_x, tile_y] = GetCoords(event.x, event.y);
+        DoSelectSet(tile_x, tile_y);
+        return;
+    }
+
+    if (tracked_fingers < 2)
+        return;
+    uint32_t moved = fingers[0].id == event.fingerId ? 0 : 1;
+    if (fingers[moved].id != event.fingerId)
+        return;
+
+    // The board follows the middle of the two fingers and scales with the distance between them.
+    const Finger& other = fingers[1 - moved];
+    float old_x = (fingers[moved].x + other.x) / 2 * SCREEN_WIDTH;
+    float old_y = (fingers[moved].y + other.y) / 2 * SCREEN_HEIGHT;
+    float old_distance = std::hypot((fingers[moved].x - other.x) * SCREEN_WIDTH, (fingers[moved].y - other.y) * SCREEN_HEIGHT);
+    fingers[moved].x = event.x;
+    fingers[moved].y = event.y;
+    float new_x = (fingers[moved].x + other.x) / 2 * SCREEN_WIDTH;
+    float new_y = (fingers[moved].y + other.y) / 2 * SCREEN_HEIGHT;
+    float new_distance = std::hypot((fingers[moved].x - other.x) * SCREEN_WIDTH, (fingers[moved].y - other.y) * SCREEN_HEIGHT);
+
+    if (old_distance > 1 && new_distance > 1)
+        camera.zoom(new_distance / old_distance, old_x, old_y);
+    camera.pan(new_x - old_x, new_y - old_y);
 }
 
 void SwitchShot::OnButtonDown(const SDL_JoyButtonEvent& event)
@@ -160,29 +685,26 @@ void SwitchShot::OnButtonDown(const SDL_JoyButtonEvent& event)
     switch (event.button)
     {
         case SDL_KEY_MINUS:
+            daily_mode = false;
             New();
             break;
         case SDL_KEY_DRIGHT:
         case SDL_KEY_LSTICK_RIGHT:
-        case SDL_KEY_RSTICK_RIGHT:
             current_tile.first = std::min(current_tile.first + 1, puzzle->width - 1);
             DoSelectSet(current_tile.first, current_tile.second);
             break;
         case SDL_KEY_DLEFT:
         case SDL_KEY_LSTICK_LEFT:
-        case SDL_KEY_RSTICK_LEFT:
             current_tile.first = std::max(current_tile.first - 1, 0U);
             DoSelectSet(current_tile.first, current_tile.second);
             break;
         case SDL_KEY_DDOWN:
         case SDL_KEY_LSTICK_DOWN:
-        case SDL_KEY_RSTICK_DOWN:
             current_tile.second = std::min(current_tile.second + 1, puzzle->height - 1);
             DoSelectSet(current_tile.first, current_tile.second);
             break;
         case SDL_KEY_DUP:
         case SDL_KEY_LSTICK_UP:
-        case SDL_KEY_RSTICK_UP:
             current_tile.second = std::max(current_tile.second - 1, 0U);
             DoSelectSet(current_tile.first, current_tile.second);
             break;
@@ -193,33 +715,87 @@ void SwitchShot::OnButtonDown(const SDL_JoyButtonEvent& event)
         case SDL_KEY_X:
             New(seed);
             break;
+        case SDL_KEY_L:
+            DoUndo();
+            break;
+        case SDL_KEY_R:
+            DoRedo();
+            break;
+        case SDL_KEY_ZR:
+            show_hint = !show_hint;
+            break;
+        case SDL_KEY_ZL:
+            show_frame_stats = !show_frame_stats;
+            break;
+        case SDL_KEY_RSTICK:
+            // Zooms all the way out, or back in around the cursor.
+            if (camera.zoomed_in())
+                camera.zoom(0, GAME_WIDTH / 2, GAME_HEIGHT / 2);
+            else
+            {
+                camera.zoom(TILE_SIZE, camera.screen_x(current_tile.first + 0.5f), camera.screen_y(current_tile.second + 0.5f));
+                camera.show(current_tile.first, current_tile.second);
+            }
+            break;
+        case SDL_KEY_PLUS:
+        {
+            SDL_Event quit = {};
+            quit.type = SDL_QUIT;
+            SDL_PushEvent(&quit);
+            break;
+        }
+        case SDL_KEY_Y:
+            // Only the difficulties with a known clear, then the daily challenge.
+            if (daily_mode)
+                daily_mode = false;
+            else if (difficulty + 1 < SeedCatalog::UNSOLVED)
+                difficulty++;
+            else
+            {
+                daily_mode = true;
+                difficulty = SeedCatalog::EASY;
+            }
+            New();
+            break;
         default:
             break;
     }
 }
 
+void SwitchShot::OnAxisMotion(const SDL_JoyAxisEvent& event)
+{
+    float value = std::abs(event.value) < STICK_DEAD_ZONE ? 0 : event.value / 32767.0f;
+    if (event.axis == PAN_AXIS_X)
+        pan_x = value;
+    else if (event.axis == PAN_AXIS_Y)
+        pan_y = value;
+}
+
 void SwitchShot::DoSelectSet(uint32_t tile_x, uint32_t tile_y)
 {
     if (tile_x == -1U || tile_y == -1U)
     {
-        points.clear();
+        selected_group = Puzzle::NO_GROUP;
+        overlay_dirty = true;
         return;
     }
 
+    camera.show(tile_x, tile_y);
     if (puzzle->at(tile_x, tile_y) == Puzzle::EMPTY)
         return;
 
     current_tile = {tile_x, tile_y};
-    if (points.find({tile_x, tile_y}) == points.end())
+    if (puzzle->label(tile_x, tile_y) != selected_group)
     {
-        points = puzzle->test(tile_x, tile_y);
+        selected_group = puzzle->group_size(tile_x, tile_y) > 1 ? puzzle->label(tile_x, tile_y) : Puzzle::NO_GROUP;
+        overlay_dirty = true;
         uint8_t current_color = puzzle->at(tile_x, tile_y);
         current_tile = {tile_x, tile_y};
         if (current_color != Puzzle::EMPTY)
         {
             auto [r, g, b] = colors[current_color];
-            modulation.set(RGBA8_MAXALPHA(std::max(0,   r - 48), std::max(0,   g - 48), std::max(0,   b - 48)),
-                           RGBA8_MAXALPHA(std::min(255, r + 48), std::min(255, g + 48), std::min(255, b + 48)), 60);
+            pulse_min = RGBA8_MAXALPHA(std::max(0,   r - 48), std::max(0,   g - 48), std::max(0,   b - 48));
+            pulse_max = RGBA8_MAXALPHA(std::min(255, r + 48), std::min(255, g + 48), std::min(255, b + 48));
         }
     }
 }
@@ -228,23 +804,89 @@ void SwitchShot::DoMatch(uint32_t tile_x, uint32_t tile_y)
 {
     if (tile_x == -1U || tile_y == -1U)
     {
-        points.clear();
+        selected_group = Puzzle::NO_GROUP;
+        overlay_dirty = true;
         return;
     }
 
     if (puzzle->at(tile_x, tile_y) == Puzzle::EMPTY)
         return;
 
-    if (points.find({tile_x, tile_y}) == points.end())
+    if (puzzle->label(tile_x, tile_y) != selected_group)
     {
         DoSelectSet(tile_x, tile_y);
         return;
     }
 
-    uint32_t matches = puzzle->match(tile_x, tile_y) - 1;
+    selected_group = Puzzle::NO_GROUP;
+
+    uint32_t cell = puzzle->index(tile_x, tile_y);
+    uint32_t matches = history.match(*puzzle, tile_x, tile_y, &moves) - 1;
+    falling.start(*puzzle, moves, FALL_TICKS);
     score += matches * matches;
+    recorder.move(cell, *puzzle);
+    SaveScore();
+    BoardChanged();
+}
 
-    points.clear();
+void SwitchShot::DoUndo()
+{
+    uint32_t size = history.undo(*puzzle);
+    if (size == 0)
+        return;
+
+    // Undone moves snap back, tiles still falling land at once.
+    if (falling.active())
+    {
+        falling.reset(puzzle->width, puzzle->height);
+        board_reset = true;
+    }
+
+    selected_group = Puzzle::NO_GROUP;
+    score -= (size - 1) * (size - 1);
+    recorder.undo(*puzzle);
+    if (puzzle->has_moves())
+        score_saved = false;
+    BoardChanged();
+}
+
+void SwitchShot::DoRedo()
+{
+    uint32_t size = history.redo(*puzzle, &moves);
+    if (size == 0)
+        return;
+    falling.start(*puzzle, moves, FALL_TICKS);
+
+    selected_group = Puzzle::NO_GROUP;
+    score += (size - 1) * (size - 1);
+    recorder.redo(*puzzle);
+    SaveScore();
+    BoardChanged();
+}
+
+void SwitchShot::SaveScore()
+{
+    if (score_saved || puzzle->has_moves())
+        return;
+
+    ScoreRecord record{};
+    record.seed = seed;
+    record.score = score;
+    record.day = Today();
+    record.remaining = puzzle->data.size() - std::count(puzzle->data.begin(), puzzle->data.end(), Puzzle::EMPTY);
+    record.mode = daily_mode ? DAILY_SCORES : difficulty;
+    scores.add(record);
+    score_saved = true;
+    // The replay of a finished game goes to the card with its score, moves before only wait in memory.
+    recorder.flush();
+}
+
+void SwitchShot::BoardChanged()
+{
+    // Drops the search on the previous board, the hint disappears until the new search has one.
+    hints.search(*puzzle);
+    hint_group = Puzzle::NO_GROUP;
+    overlay_dirty = true;
 }
 
 int main(int argc, char *argv[])
@@ -0,0 +1,99 @@
+#include "modulation_bank.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// The loops work a block of LANES at a time on arrays that cannot overlap, which GCC vectorizes at -O2.
+
+void advance(uint32_t* __restrict phase, const uint32_t* __restrict increment, size_t count)
+{
+    for (size_t block = 0; block < count; block += ModulationBank::LANES)
+        for (size_t lane = 0; lane < ModulationBank::LANES; lane++)
+            phase[block + lane] += increment[block + lane];
+}
+
+// Triangle wave from 0 to 65535 and back. The second half of the cycle has its top bit set, flipping every bit then
+// walks the wave back down.
+void wave(const uint32_t* __restrict phase, const uint32_t* __restrict increment, uint32_t fraction,
+          int32_t* __restrict level, size_t count)
+{
+    for (size_t block = 0; block < count; block += ModulationBank::LANES)
+    {
+        for (size_t lane = 0; lane < ModulationBank::LANES; lane++)
+        {
+            uint32_t at = phase[block + lane] + (increment[block + lane] >> 16) * fraction;
+            uint32_t folded = at ^ static_cast<uint32_t>(static_cast<int32_t>(at) >> 31);
+            level[block + lane] = folded >> 15;
+        }
+    }
+}
+
+void blend(const int32_t* __restrict base, const int32_t* __restrict range, const int32_t* __restrict level,
+           uint8_t* __restrict color, size_t count)
+{
+    for (size_t block = 0; block < count; block += ModulationBank::LANES)
+        for (size_t lane = 0; lane < ModulationBank::LANES; lane++)
+            color[block + lane] = base[block + lane] + ((range[block + lane] * level[block + lane]) >> 16);
+}
+
+}
+
+void ModulationBank::clear()
+{
+    count = 0;
+    phase.clear();
+    increment.clear();
+    level.clear();
+    for (int channel = 0; channel < CHANNELS; channel++)
+    {
+        base[channel].clear();
+        range[channel].clear();
+        color[channel].clear();
+    }
+}
+
+uint32_t ModulationBank::add(uint32_t min, uint32_t max, uint32_t period, float start)
+{
+    // Arrays grow a whole block at a time, the padding modulators have a range of 0 and stay black.
+    if (count % LANES == 0)
+    {
+        phase.resize(count + LANES, 0);
+        increment.resize(count + LANES, 0);
+        level.resize(count + LANES, 0);
+        for (int channel = 0; channel < CHANNELS; channel++)
+        {
+            base[channel].resize(count + LANES, 0);
+            range[channel].resize(count + LANES, 0);
+            color[channel].resize(count + LANES, 0);
+        }
+    }
+
+    // Whole turns wrap away converting to 32 bits, start - floor(start) could round up to 1.0f and overflow.
+    phase[count] = static_cast<uint32_t>(std::llround(static_cast<double>(start) * 4294967296.0));
+    increment[count] = static_cast<uint32_t>(4294967296.0 / std::max(period, 2u));
+    for (int channel = 0; channel < CHANNELS; channel++)
+    {
+        int32_t low = min >> (8 * channel) & 0xFF;
+        int32_t high = max >> (8 * channel) & 0xFF;
+        base[channel][count] = low;
+        range[channel][count] = high - low;
+        color[channel][count] = low;
+    }
+    return count++;
+}
+
+void ModulationBank::update()
+{
+    advance(phase.data(), increment.data(), phase.size());
+}
+
+void ModulationBank::evaluate(float alpha)
+{
+    const uint32_t fraction = static_cast<uint32_t>(std::min(std::max(alpha, 0.0f), 1.0f) * 65535);
+    wave(phase.data(), increment.data(), fraction, level.data(), phase.size());
+    for (int channel = 0; channel < CHANNELS; channel++)
+        blend(base[channel].data(), range[channel].data(), level.data(), color[channel].data(), phase.size());
+}
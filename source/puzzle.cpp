@@ -1,112 +1,400 @@
 #include "puzzle.hpp"
 
-#include <cstdlib>
-#include <deque>
-#include <list>
-#include <set>
+#include <algorithm>
+#include <cstring>
 
-uint32_t Puzzle::match(uint32_t x, uint32_t y)
+uint32_t Puzzle::match(uint32_t x, uint32_t y, move_list* moves)
 {
-    auto matched = test(x, y);
+    const auto& matched = test(x, y);
 
     if (matched.size() <= 1)
         return 1;
 
-    for (const auto [x, y] : matched)
-        data[y * width + x] = EMPTY;
+    uint32_t matches = matched.size();
+    for (const auto cell : matched)
+        data[cell] = EMPTY;
 
-    compact(matched);
+    compact(matched, moves);
 
-    return matched.size();
+    return matches;
 }
 
-Puzzle::point_set Puzzle::test(uint32_t x, uint32_t y) const
+const Puzzle::cell_list& Puzzle::test(uint32_t x, uint32_t y) const
 {
-    point_set visited;
+    group.clear();
 
-    uint8_t color = data[y * width + x];
+    uint32_t start = index(x, y);
+    uint8_t color = data[start];
     if (color == EMPTY)
-        return visited;
+        return group;
 
-    std::deque<std::pair<uint32_t, uint32_t>> queue;
+    next_generation();
 
-    queue.push_back({x, y});
-    visited.insert({x, y});
+    auto visit = [this, color](uint32_t cell)
+    {
+        if (visited[cell] != generation && data[cell] == color)
+        {
+            visited[cell] = generation;
+            group.push_back(cell);
+        }
+    };
+
+    visited[start] = generation;
+    group.push_back(start);
 
-    while (!queue.empty())
+    // The group doubles as the work queue, each cell is appended exactly once.
+    for (size_t i = 0; i < group.size(); i++)
     {
-        auto [x, y] = queue.front();
-        queue.pop_front();
+        uint32_t cell = group[i];
+        uint32_t cx = cell_x(cell);
+        uint32_t cy = cell_y(cell);
+
+        if (cx >= 1)         visit(cell - height);
+        if (cx + 1 < width)  visit(cell + height);
+        if (cy >= 1)         visit(cell - 1);
+        if (cy + 1 < height) visit(cell + 1);
+    }
+
+    if (group.size() == 1)
+        group.clear();
 
-        if (visited.find({x - 1, y}) == visited.end() && x >= 1         && data[y * width + x - 1] == color)
+    return group;
+}
+
+bool Puzzle::random_move(Random& random, uint32_t& x, uint32_t& y) const
+{
+    if (!has_moves())
+        return false;
+
+    for (int i = 0; i < 64; i++)
+    {
+        x = random.below(width);
+        y = random.below(height);
+        if (group_size(x, y) > 1)
+            return true;
+    }
+
+    for (x = 0; x < width; x++)
+        for (y = 0; y < height; y++)
+            if (group_size(x, y) > 1)
+                return true;
+
+    return false;
+}
+
+void Puzzle::compact(const cell_list& hints, move_list* moves)
+{
+    // Per column, how many cells went and the lowest of them. Nothing below that row moves.
+    touched.clear();
+    for (const auto cell : hints)
+    {
+        uint32_t x = cell_x(cell);
+        if (removed[x]++ == 0)
         {
-            queue.push_back({x - 1, y});
-            visited.insert({x - 1, y});
+            touched.push_back(x);
+            lowest[x] = 0;
         }
-        if (visited.find({x + 1, y}) == visited.end() && x + 1 < width  && data[y * width + x + 1] == color)
+        lowest[x] = std::max(cell_y(cell), lowest[x]);
+        set_label(cell, NO_GROUP);
+    }
+
+    if (touched.empty())
+        return;
+    std::sort(touched.begin(), touched.end());
+
+    if (moves)
+    {
+        moves->clear();
+        for (const auto cell : hints)
+            moves->push_back({cell, REMOVED});
+
+        // Where each tile lands, worked out before the board changes. Tiles fall to the bottom of their column
+        // and once a column empties every column right of it moves over.
+        uint32_t shift = 0;
+        size_t next = 0;
+        for (uint32_t x = touched.front(); x < used_columns; x++)
         {
-            queue.push_back({x + 1, y});
-            visited.insert({x + 1, y});
+            uint32_t top = height - heights[x];
+            if (next < touched.size() && touched[next] == x)
+            {
+                next++;
+                uint32_t to_y = shift ? height : lowest[x] + 1;
+                for (uint32_t y = to_y; y-- > top;)
+                {
+                    if (data[index(x, y)] == EMPTY)
+                        continue;
+                    if (--to_y != y || shift)
+                        moves->push_back({index(x, y), index(x - shift, to_y)});
+                }
+                if (removed[x] == heights[x])
+                    shift++;
+            }
+            else if (shift)
+            {
+                for (uint32_t y = height; y-- > top;)
+                    moves->push_back({index(x, y), index(x - shift, y)});
+            }
+            else if (next < touched.size())
+                x = touched[next] - 1;
+            else
+                break;
         }
-        if (visited.find({x, y - 1}) == visited.end() && y >= 1         && data[(y - 1) * width + x] == color)
+    }
+
+    // Gravity, a stable compaction of each column down to its lowest removed cell. Labels move with their tiles.
+    emptied.clear();
+    for (const auto x : touched)
+    {
+        uint8_t* column = &data[index(x, 0)];
+        uint32_t* column_labels = &labels[index(x, 0)];
+        uint32_t top = height - heights[x];
+        uint32_t to = lowest[x] + 1;
+        for (uint32_t y = to; y-- > top;)
         {
-            queue.push_back({x, y - 1});
-            visited.insert({x, y - 1});
+            if (column[y] != EMPTY)
+            {
+                to--;
+                column[to] = column[y];
+                column_labels[to] = column_labels[y];
+            }
         }
-        if (visited.find({x, y + 1}) == visited.end() && y + 1 < height && data[(y + 1) * width + x] == color)
+        std::fill(column + top, column + to, EMPTY);
+        std::fill(column_labels + top, column_labels + to, NO_GROUP);
+
+        heights[x] -= removed[x];
+        if (heights[x] == 0)
+            emptied.push_back(x);
+    }
+
+    // Slide the columns that are left over the emptied ones, each run between two of them as one block.
+    uint32_t maxx = touched.back();
+    if (!emptied.empty())
+    {
+        maxx = used_columns - 1;
+        for (size_t i = 0; i < emptied.size(); i++)
         {
-            queue.push_back({x, y + 1});
-            visited.insert({x, y + 1});
+            uint32_t first = emptied[i] + 1;
+            uint32_t last = i + 1 < emptied.size() ? emptied[i + 1] : used_columns;
+            move_columns(first, last, first - (i + 1));
         }
+        clear_columns(used_columns - emptied.size(), used_columns);
+        used_columns -= emptied.size();
     }
+    mark_changed(touched.front(), maxx);
 
-    if (visited.size() == 1)
-        visited.clear();
+    // Every group that changed has a cell in the rows that changed or right next to them, the parts of a split
+    // group all touch those rows. Flooding from there rewrites every stale label, groups not reached keep theirs.
+    // The two columns an emptied one leaves side by side may join groups anywhere along their height.
+    next_generation();
+    size_t gaps = 0;
+    for (const auto x : touched)
+    {
+        if (gaps < emptied.size() && emptied[gaps] == x)
+        {
+            gaps++;
+            uint32_t right = x + 1 - gaps;
+            if (right > 0)
+                relabel(right - 1, 0, height - 1);
+            if (right < used_columns)
+                relabel(right, 0, height - 1);
+            continue;
+        }
+
+        uint32_t to_x = x - gaps;
+        uint32_t first = height - heights[to_x] - removed[x];
+        if (to_x > 0)
+            relabel(to_x - 1, first, lowest[x]);
+        relabel(to_x, first, std::min(lowest[x] + 1, height - 1));
+        if (to_x + 1 < used_columns)
+            relabel(to_x + 1, first, lowest[x]);
+    }
+    group.clear();
 
-    return visited;
+    for (const auto x : touched)
+        removed[x] = 0;
 }
 
-void Puzzle::compact(const point_set& hints)
+void Puzzle::restore(const cell_list& cells, uint8_t color, const cell_list& columns)
 {
-    uint32_t minx = width, miny = height, maxx = 0, maxy = 0;
-    for (const auto [x, y] : hints)
+    if (cells.empty())
+        return;
+
+    // Open the emptied columns up again, moving everything right of them over by one.
+    for (const auto x : columns)
     {
-        minx = std::min(x, minx);
-        miny = std::min(y, miny);
-        maxx = std::max(x, maxx);
-        maxy = std::max(y, maxy);
+        move_columns(x, used_columns, x + 1);
+        clear_columns(x, x + 1);
+        used_columns++;
     }
 
-    int32_t x_mark = -1;
-    for (uint32_t x = minx; x <= maxx; x++)
+    // Each column is the stack left by gravity with the removed cells put back at their rows.
+    // Filling from the top down reads each remaining cell before its row is written over.
+    for (size_t i = 0; i < cells.size();)
     {
-        int32_t y_mark = -1;
-        bool moved_one = false;
-        for (int32_t y = maxy; y >= 0 ; y--)
+        uint32_t x = cell_x(cells[i]);
+        size_t end = i;
+        while (end < cells.size() && cell_x(cells[end]) == x)
+            end++;
+
+        uint8_t* column = &data[index(x, 0)];
+        uint32_t top = height - heights[x];
+        heights[x] += end - i;
+
+        uint32_t from = top;
+        for (uint32_t y = top - (end - i); i < end; y++)
         {
-            if (y_mark == -1 && data[y * width + x] == EMPTY)
-                y_mark = y;
-            else if ((y_mark != -1 || x_mark != -1) && data[y * width + x] != EMPTY)
+            if (y == cell_y(cells[i]))
             {
-                int32_t movex = x_mark == -1 ? x : x_mark;
-                int32_t movey = y_mark == -1 ? y : y_mark;
-                std::swap(data[movey * width + movex], data[y * width + x]);
-                if (y_mark != -1) y_mark--;
-                moved_one = true;
+                column[y] = color;
+                i++;
             }
+            else
+                column[y] = column[from++];
         }
-        if (x_mark == -1 && maxy == height - 1 && data[(height - 1) * width + x] == EMPTY)
+    }
+
+    uint32_t maxx = cell_x(cells.back());
+    mark_changed(cell_x(cells.front()), columns.empty() ? maxx : used_columns - 1);
+    relabel(cell_x(cells.front()), maxx);
+}
+
+void Puzzle::relabel()
+{
+    std::fill(labels.begin(), labels.end(), NO_GROUP);
+    sizes.clear();
+    free_labels.clear();
+    movable_groups = 0;
+
+    relabel(0, width - 1);
+}
+
+void Puzzle::relabel(uint32_t minx, uint32_t maxx)
+{
+    // Every group that changed has a cell in columns [minx, maxx] or in the columns bordering them,
+    // the parts of a split group outside of the range all touch a bordering column.
+    minx = minx > 0 ? minx - 1 : 0;
+    maxx = std::min(maxx + 1, width - 1);
+
+    next_generation();
+    for (uint32_t x = minx; x <= maxx; x++)
+        relabel(x, 0, height - 1);
+    group.clear();
+}
+
+void Puzzle::relabel(uint32_t x, uint32_t first_y, uint32_t last_y)
+{
+    // Rows above the top tile are empty and already have no group.
+    for (uint32_t y = std::max(first_y, height - heights[x]); y <= last_y; y++)
+        flood(index(x, y));
+}
+
+void Puzzle::flood(uint32_t start)
+{
+    uint8_t color = data[start];
+    if (color == EMPTY || visited[start] == generation)
+        return;
+
+    uint32_t group_label;
+    if (free_labels.empty())
+    {
+        group_label = sizes.size();
+        sizes.push_back(0);
+    }
+    else
+    {
+        group_label = free_labels.back();
+        free_labels.pop_back();
+    }
+
+    group.clear();
+    visited[start] = generation;
+    group.push_back(start);
+
+    auto visit = [this, color](uint32_t neighbor)
+    {
+        if (visited[neighbor] != generation && data[neighbor] == color)
         {
-            x_mark = x;
-            maxx = width - 1;
+            visited[neighbor] = generation;
+            group.push_back(neighbor);
         }
-        else if (x_mark != -1 && (data[(height - 1) * width + x] != EMPTY || moved_one))
-            x_mark++;
+    };
+
+    for (size_t i = 0; i < group.size(); i++)
+    {
+        uint32_t cell = group[i];
+        uint32_t cx = cell_x(cell);
+        uint32_t cy = cell_y(cell);
+        set_label(cell, group_label);
+
+        if (cx >= 1)         visit(cell - height);
+        if (cx + 1 < width)  visit(cell + height);
+        if (cy >= 1)         visit(cell - 1);
+        if (cy + 1 < height) visit(cell + 1);
+    }
+}
+
+void Puzzle::move_columns(uint32_t first, uint32_t last, uint32_t to)
+{
+    // Columns [first, last) move to start at to, labels and heights along with the tiles.
+    uint32_t cells = (last - first) * height;
+    std::memmove(data.data() + index(to, 0), data.data() + index(first, 0), cells);
+    std::memmove(labels.data() + index(to, 0), labels.data() + index(first, 0), cells * sizeof(uint32_t));
+    std::memmove(heights.data() + to, heights.data() + first, (last - first) * sizeof(uint32_t));
+}
+
+void Puzzle::clear_columns(uint32_t first, uint32_t last)
+{
+    // Left behind by move_columns, the tiles and labels there live on elsewhere.
+    std::fill(data.begin() + index(first, 0), data.begin() + index(last, 0), EMPTY);
+    std::fill(labels.begin() + index(first, 0), labels.begin() + index(last, 0), NO_GROUP);
+    std::fill(heights.begin() + first, heights.begin() + last, 0);
+}
+
+void Puzzle::set_label(uint32_t cell, uint32_t group_label)
+{
+    uint32_t old_label = labels[cell];
+    if (old_label == group_label)
+        return;
+
+    if (old_label != NO_GROUP)
+    {
+        if (sizes[old_label] == 2)
+            movable_groups--;
+        if (--sizes[old_label] == 0)
+            free_labels.push_back(old_label);
+    }
+
+    if (group_label != NO_GROUP)
+    {
+        if (++sizes[group_label] == 2)
+            movable_groups++;
+    }
+
+    labels[cell] = group_label;
+}
+
+void Puzzle::mark_changed(uint32_t minx, uint32_t maxx)
+{
+    changed_minx = std::min(changed_minx, minx);
+    changed_maxx = std::max(changed_maxx, maxx);
+}
+
+void Puzzle::next_generation() const
+{
+    if (++generation == 0)
+    {
+        std::fill(visited.begin(), visited.end(), 0);
+        generation = 1;
     }
 }
 
 void Puzzle::randomize()
 {
-    for (unsigned int i = 0; i < data.size(); i++)
-        data[i] = rand() % colors;
+    // Dealt column by column from the left, each column from the top.
+    random.fill(data.data(), data.size(), colors);
+    std::fill(heights.begin(), heights.end(), height);
+    used_columns = width;
+
+    mark_changed(0, width - 1);
+    relabel();
 }
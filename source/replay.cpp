@@ -0,0 +1,260 @@
+#include "replay.hpp"
+#include "history.hpp"
+#include "varint.hpp"
+
+#include <cstring>
+
+static const char MAGIC[4] = {'S', 'S', 'R', 'P'};
+
+// FNV-1a of column x mixed with x, so equal columns in different places add up to different hashes.
+static uint64_t column_hash(const Puzzle& puzzle, uint32_t x)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    const uint8_t* column = &puzzle.data[puzzle.index(x, 0)];
+    for (uint32_t y = 0; y < puzzle.height; y++)
+    {
+        hash ^= column[y];
+        hash *= 0x100000001B3ULL;
+    }
+
+    hash ^= (x + 1) * 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+}
+
+uint64_t board_hash(const Puzzle& puzzle)
+{
+    uint64_t hash = 0;
+    for (uint32_t x = 0; x < puzzle.width; x++)
+        hash += column_hash(puzzle, x);
+    return hash;
+}
+
+uint64_t BoardHash::reset(Puzzle& puzzle)
+{
+    columns.resize(puzzle.width);
+    hash = 0;
+    for (uint32_t x = 0; x < puzzle.width; x++)
+        hash += columns[x] = column_hash(puzzle, x);
+    puzzle.reset_changes();
+    return hash;
+}
+
+uint64_t BoardHash::update(Puzzle& puzzle)
+{
+    auto [minx, maxx] = puzzle.changes();
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        uint64_t column = column_hash(puzzle, x);
+        hash += column - columns[x];
+        columns[x] = column;
+    }
+    puzzle.reset_changes();
+    return hash;
+}
+
+bool ReplayWriter::open(const char* filename, uint64_t seed, const Puzzle& puzzle, bool hashes)
+{
+    close();
+
+    file = fopen(filename, "wb");
+    if (!file)
+        return false;
+
+    ReplayHeader header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = Replay::VERSION;
+    header.seed = seed;
+    header.width = puzzle.width;
+    header.height = puzzle.height;
+    header.colors = puzzle.colors;
+    header.flags = flags = hashes ? REPLAY_HASHES : 0;
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    recorded.assign(bytes, bytes + sizeof(header));
+    quit = false;
+    worker = std::thread([this] {work();});
+    flush();
+    return true;
+}
+
+void ReplayWriter::close()
+{
+    if (worker.joinable())
+    {
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            quit = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    if (file)
+        fclose(file);
+    file = nullptr;
+}
+
+void ReplayWriter::flush()
+{
+    if (recorded.empty() || !worker.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.insert(queue.end(), recorded.begin(), recorded.end());
+    }
+    recorded.clear();
+    wake.notify_one();
+}
+
+void ReplayWriter::action(uint32_t value, const Puzzle& puzzle)
+{
+    if (!worker.joinable())
+        return;
+
+    uint8_t bytes[VARINT_MAX_BYTES + sizeof(uint64_t)];
+    size_t size = write_varint(bytes, value);
+    if (flags & REPLAY_HASHES)
+    {
+        uint64_t hash = board_hash(puzzle);
+        memcpy(bytes + size, &hash, sizeof(hash));
+        size += sizeof(hash);
+    }
+    recorded.insert(recorded.end(), bytes, bytes + size);
+}
+
+void ReplayWriter::work()
+{
+    // Swapped with the queue, so the game thread keeps appending to storage that is already allocated.
+    std::vector<uint8_t> bytes;
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true)
+    {
+        wake.wait(lock, [this] {return quit || !queue.empty();});
+        if (queue.empty())
+            break;
+
+        bytes.clear();
+        bytes.swap(queue);
+        lock.unlock();
+
+        if (file && (fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size() || fflush(file) != 0))
+        {
+            printf("Could not write the replay, recording stopped\n");
+            fclose(file);
+            file = nullptr;
+        }
+
+        lock.lock();
+    }
+}
+
+bool Replay::load(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+        return false;
+
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              (header.version == VERSION || (header.version == 1 && !has_hashes()));
+    if (ok)
+    {
+        data.clear();
+        uint8_t buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            data.insert(data.end(), buffer, buffer + read);
+    }
+    fclose(file);
+    if (!ok)
+        return false;
+
+    // Walk the actions once to find where the last complete one ends.
+    size_t hash_size = has_hashes() ? sizeof(uint64_t) : 0;
+    size_t end = 0;
+    has_undo = false;
+    while (end < data.size())
+    {
+        size_t offset = end;
+        while (offset < data.size() && (data[offset] & 0x80))
+            offset++;
+        // Longer than any uint32_t is written, the file is corrupt rather than cut short.
+        if (offset - end >= VARINT_MAX_BYTES ||
+            (offset - end == VARINT_MAX_BYTES - 1 && offset < data.size() && data[offset] > 0x0F))
+        {
+            data.clear();
+            return false;
+        }
+        if (offset >= data.size() || offset + 1 + hash_size > data.size())
+            break;
+
+        size_t start = end;
+        has_undo = has_undo || read_varint(data.data(), start) < 2;
+        end = offset + 1 + hash_size;
+    }
+    data.resize(end);
+
+    return true;
+}
+
+bool Replay::play(Puzzle& puzzle, uint32_t& score, uint32_t& actions, std::vector<uint64_t>* hashes) const
+{
+    History history;
+    score = 0;
+    actions = 0;
+
+    BoardHash running;
+    const bool hashing = hashes || has_hashes();
+    if (hashing)
+        running.reset(puzzle);
+
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        uint32_t value = read_varint(data.data(), offset);
+        if (value >= 2)
+        {
+            uint32_t cell = value - 2;
+            if (cell >= puzzle.width * puzzle.height)
+                return false;
+
+            uint32_t x = puzzle.cell_x(cell), y = puzzle.cell_y(cell);
+            uint32_t size = has_undo ? history.match(puzzle, x, y) : puzzle.match(x, y);
+            if (size <= 1)
+                return false;
+            score += (size - 1) * (size - 1);
+        }
+        else
+        {
+            uint32_t size = value == 0 ? history.undo(puzzle) : history.redo(puzzle);
+            if (size == 0)
+                return false;
+            if (value == 0)
+                score -= (size - 1) * (size - 1);
+            else
+                score += (size - 1) * (size - 1);
+        }
+
+        if (hashing)
+        {
+            uint64_t hash = running.update(puzzle);
+            if (has_hashes())
+            {
+                uint64_t recorded;
+                memcpy(&recorded, &data[offset], sizeof(recorded));
+                offset += sizeof(recorded);
+                if (hash != recorded)
+                    return false;
+            }
+            if (hashes)
+                hashes->push_back(hash);
+        }
+
+        actions++;
+    }
+
+    return true;
+}
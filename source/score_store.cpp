@@ -0,0 +1,278 @@
+#include "score_store.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+
+namespace
+{
+
+typedef std::chrono::steady_clock steady_clock;
+
+const char MAGIC[4] = {'S', 'S', 'H', 'S'};
+
+// FNV-1a.
+uint32_t checksum(const void* data, size_t size, uint32_t hash = 2166136261u)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+uint32_t checksum(const ScoreStore::JournalEntry& entry)
+{
+    return checksum(&entry.record, sizeof(entry.record), checksum(&entry.sequence, sizeof(entry.sequence)));
+}
+
+uint32_t microseconds_since(steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - start).count();
+}
+
+// The data only counts once it reached the card, not when it left the C library's buffer.
+bool sync(FILE* file)
+{
+    return fflush(file) == 0 && fsync(fileno(file)) == 0;
+}
+
+bool read_snapshot(const std::string& filename, HighScores& scores, uint32_t& sequence)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return false;
+
+    ScoreStore::SnapshotHeader header;
+    HighScores read;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && fread(&read, sizeof(read), 1, file) == 1 &&
+              memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == ScoreStore::VERSION &&
+              header.checksum == checksum(&read, sizeof(read));
+    fclose(file);
+
+    if (ok)
+    {
+        scores = read;
+        sequence = header.sequence;
+    }
+    return ok;
+}
+
+}
+
+void HighScores::add(const ScoreRecord& record)
+{
+    if (record.mode >= MODES)
+        return;
+
+    Stats& mode_stats = stats[record.mode];
+    mode_stats.games++;
+    mode_stats.cleared += record.remaining == 0;
+    mode_stats.total_score += record.score;
+
+    // Ties keep the earlier game ahead.
+    ScoreRecord* best = top[record.mode];
+    uint32_t& used = count[record.mode];
+    uint32_t position = 0;
+    while (position < used && best[position].score >= record.score)
+        position++;
+    if (position == TOP)
+        return;
+
+    if (used < TOP)
+        used++;
+    memmove(&best[position + 1], &best[position], (used - 1 - position) * sizeof(ScoreRecord));
+    best[position] = record;
+}
+
+bool ScoreStore::open(const std::string& snapshot, const std::string& journal_name)
+{
+    close();
+
+    snapshot_file = snapshot;
+    journal_file = journal_name;
+    current = HighScores();
+    sequence = 0;
+
+    // A crash between writing the new snapshot and renaming it can leave either one, the newer one wins.
+    HighScores pending_scores{};
+    uint32_t pending_sequence = 0;
+    bool loaded = read_snapshot(snapshot_file, current, sequence);
+    if (read_snapshot(snapshot_file + ".tmp", pending_scores, pending_sequence) &&
+        (!loaded || pending_sequence > sequence))
+    {
+        current = pending_scores;
+        sequence = pending_sequence;
+        loaded = true;
+    }
+
+    // Entries the snapshot already has are skipped, the journal ends at the first one cut short or out of order.
+    bool stale_journal = false;
+    if (FILE* file = fopen(journal_file.c_str(), "rb"))
+    {
+        JournalEntry entry;
+        while (fread(&entry, sizeof(entry), 1, file) == 1 && entry.checksum == checksum(entry) &&
+               entry.sequence <= sequence)
+        {
+            if (entry.sequence == sequence)
+            {
+                current.add(entry.record);
+                sequence++;
+            }
+            loaded = true;
+        }
+        stale_journal = ftell(file) > 0;
+        fclose(file);
+    }
+
+    saved = current;
+    saved_sequence = sequence;
+    written_sequence = sequence;
+    journaled = 0;
+    quit = false;
+    io = IoStats();
+
+    // What was loaded goes into a fresh snapshot, new entries are never appended after a torn one.
+    worker = std::thread([this, stale_journal] {work(stale_journal);});
+    return loaded;
+}
+
+void ScoreStore::close()
+{
+    if (worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            quit = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    if (journal)
+        fclose(journal);
+    journal = nullptr;
+}
+
+void ScoreStore::add(const ScoreRecord& record)
+{
+    current.add(record);
+
+    JournalEntry entry{sequence++, 0, record};
+    entry.checksum = checksum(entry);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(entry);
+    }
+    wake.notify_one();
+}
+
+void ScoreStore::flush()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    written.wait(lock, [this] {return written_sequence >= sequence || !worker.joinable();});
+}
+
+ScoreStore::IoStats ScoreStore::io_stats()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return io;
+}
+
+void ScoreStore::work(bool compact_first)
+{
+    if (compact_first)
+    {
+        auto start = steady_clock::now();
+        bool ok = compact();
+        uint32_t time = microseconds_since(start);
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        io.snapshots++;
+        io.failures += !ok;
+        io.worst_snapshot_us = std::max(io.worst_snapshot_us, time);
+    }
+
+    // Swapped with the queue, so the game thread keeps pushing into storage that is already allocated.
+    std::vector<JournalEntry> entries;
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true)
+    {
+        wake.wait(lock, [this] {return quit || !queue.empty();});
+        if (queue.empty())
+            break;
+
+        entries.clear();
+        entries.swap(queue);
+        lock.unlock();
+
+        auto start = steady_clock::now();
+        bool appended = append(entries);
+        uint32_t append_time = microseconds_since(start);
+
+        // A failed append may have left a torn entry, a snapshot makes the journal start over behind it.
+        bool compacted = false, snapshot_ok = true;
+        uint32_t snapshot_time = 0;
+        if (!appended || journaled >= COMPACT_EVERY)
+        {
+            start = steady_clock::now();
+            snapshot_ok = compact();
+            snapshot_time = microseconds_since(start);
+            compacted = true;
+        }
+
+        lock.lock();
+        io.appended += entries.size();
+        io.snapshots += compacted;
+        io.failures += !appended + !snapshot_ok;
+        io.worst_append_us = std::max(io.worst_append_us, append_time);
+        io.worst_snapshot_us = std::max(io.worst_snapshot_us, snapshot_time);
+        written_sequence = entries.back().sequence + 1;
+        written.notify_all();
+    }
+}
+
+bool ScoreStore::append(const std::vector<JournalEntry>& entries)
+{
+    for (const auto& entry : entries)
+        saved.add(entry.record);
+    saved_sequence = entries.back().sequence + 1;
+    journaled += entries.size();
+
+    if (!journal)
+        journal = fopen(journal_file.c_str(), "ab");
+    return journal && fwrite(entries.data(), sizeof(JournalEntry), entries.size(), journal) == entries.size() &&
+           sync(journal);
+}
+
+bool ScoreStore::compact()
+{
+    const std::string temporary = snapshot_file + ".tmp";
+    FILE* out = fopen(temporary.c_str(), "wb");
+    if (!out)
+        return false;
+
+    SnapshotHeader header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sequence = saved_sequence;
+    header.checksum = checksum(&saved, sizeof(saved));
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 && fwrite(&saved, sizeof(saved), 1, out) == 1 && sync(out);
+    ok = fclose(out) == 0 && ok;
+    if (!ok)
+        return false;
+
+    // Renaming over a file fails on some file systems, the snapshot then goes first and loading falls back on
+    // the temporary file if a crash comes in between.
+    if (rename(temporary.c_str(), snapshot_file.c_str()) != 0 &&
+        (remove(snapshot_file.c_str()) != 0 || rename(temporary.c_str(), snapshot_file.c_str()) != 0))
+        return false;
+
+    // Everything journaled is in the snapshot now.
+    if (journal)
+        fclose(journal);
+    journal = fopen(journal_file.c_str(), "wb");
+    journaled = 0;
+    return journal != nullptr;
+}
@@ -0,0 +1,100 @@
+#include "seed_catalog.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static const char MAGIC[4] = {'S', 'S', 'C', 'T'};
+
+bool SeedCatalog::open(const char* filename)
+{
+    close();
+
+    file = fopen(filename, "rb");
+    if (!file)
+        return false;
+
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION)
+    {
+        close();
+        return false;
+    }
+
+    // Lower bound of every difficulty, about log2(count) reads each.
+    first[DIFFICULTIES] = header.count;
+    for (uint8_t difficulty = 0; difficulty < DIFFICULTIES; difficulty++)
+    {
+        uint32_t low = difficulty ? first[difficulty - 1] : 0, high = header.count;
+        while (low < high)
+        {
+            uint32_t middle = low + (high - low) / 2;
+            SeedEntry entry;
+            if (!read(middle, entry))
+            {
+                close();
+                return false;
+            }
+
+            if (entry.difficulty < difficulty)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        first[difficulty] = low;
+    }
+
+    return true;
+}
+
+void SeedCatalog::close()
+{
+    if (file)
+        fclose(file);
+    file = nullptr;
+    header = Header();
+    std::fill(std::begin(first), std::end(first), 0);
+}
+
+bool SeedCatalog::get(uint8_t difficulty, uint32_t index, SeedEntry& entry) const
+{
+    if (!file || difficulty >= DIFFICULTIES || index >= size(difficulty))
+        return false;
+
+    return read(first[difficulty] + index, entry);
+}
+
+bool SeedCatalog::read(uint32_t index, SeedEntry& entry) const
+{
+    long offset = sizeof(Header) + static_cast<long>(index) * sizeof(SeedEntry);
+    return fseek(file, offset, SEEK_SET) == 0 && fread(&entry, sizeof(entry), 1, file) == 1;
+}
+
+bool SeedCatalog::write(const char* filename, std::vector<SeedEntry>& entries, uint32_t width, uint32_t height, uint8_t colors)
+{
+    std::sort(entries.begin(), entries.end(), [](const SeedEntry& a, const SeedEntry& b)
+    {
+        return a.difficulty != b.difficulty ? a.difficulty < b.difficulty : a.seed < b.seed;
+    });
+
+    FILE* out = fopen(filename, "wb");
+    if (!out)
+        return false;
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = entries.size();
+    header.width = width;
+    header.height = height;
+    header.colors = colors;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(entries.data(), sizeof(SeedEntry), entries.size(), out) == entries.size();
+    return fclose(out) == 0 && ok;
+}
+
+const char* SeedCatalog::name(uint8_t difficulty)
+{
+    static const char* names[DIFFICULTIES] = {"easy", "normal", "hard", "unsolved"};
+    return difficulty < DIFFICULTIES ? names[difficulty] : "?";
+}
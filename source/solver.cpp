@@ -0,0 +1,701 @@
+#include "solver.hpp"
+#include "bitboard.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+Zobrist::Zobrist(uint32_t cells, uint8_t c, uint64_t seed) : colors(c), keys(cells * c)
+{
+    for (auto& key : keys)
+        key = splitmix64(seed);
+}
+
+uint64_t Zobrist::hash(const Puzzle& puzzle) const
+{
+    uint64_t hash = 0;
+    for (uint32_t i = 0; i < puzzle.data.size(); i++)
+    {
+        uint8_t c = puzzle.data[i];
+        if (c != Puzzle::EMPTY)
+            hash ^= keys[i * colors + c];
+    }
+    return hash;
+}
+
+namespace
+{
+
+typedef std::array<uint32_t, 256> color_counts;
+
+struct Move
+{
+    /** Backend specific cell id. */
+    uint32_t cell;
+    uint32_t size;
+};
+
+// Searches run on any board type through a backend, which lists moves, applies them and hashes boards.
+
+// A puzzle with its Zobrist hash, which moves update from the tiles they removed and moved.
+struct KeyedPuzzle
+{
+    Puzzle puzzle;
+    uint64_t key;
+};
+
+class PuzzleBackend
+{
+public:
+    typedef KeyedPuzzle Board;
+
+    PuzzleBackend(const Puzzle& root) : zobrist(root.width * root.height, root.colors), seen(root.width * root.height, 0) {}
+
+    Board board(const Puzzle& puzzle) const {return {puzzle, zobrist.hash(puzzle)};}
+
+    void moves(const Board& board, std::vector<Move>& moves)
+    {
+        const Puzzle& puzzle = board.puzzle;
+        moves.clear();
+
+        if (++generation == 0)
+        {
+            std::fill(seen.begin(), seen.end(), 0);
+            generation = 1;
+        }
+
+        for (uint32_t y = 0; y < puzzle.height; y++)
+        {
+            for (uint32_t x = 0; x < puzzle.width; x++)
+            {
+                uint32_t size = puzzle.group_size(x, y);
+                if (size < 2)
+                    continue;
+
+                uint32_t label = puzzle.label(x, y);
+                if (seen[label] == generation)
+                    continue;
+
+                seen[label] = generation;
+                moves.push_back({puzzle.index(x, y), size});
+            }
+        }
+    }
+
+    uint32_t apply(Board& board, uint32_t cell)
+    {
+        Puzzle& puzzle = board.puzzle;
+        uint8_t color = puzzle.data[cell];
+        uint32_t size = puzzle.match(puzzle.cell_x(cell), puzzle.cell_y(cell), &tile_moves);
+        if (size <= 1)
+            return size;
+
+        // Removed tiles had the color of the group, moved ones have the color now found where they went.
+        for (const auto& move : tile_moves)
+        {
+            if (move.to == Puzzle::REMOVED)
+                board.key ^= zobrist.key(move.from, color);
+            else
+                board.key ^= zobrist.key(move.from, puzzle.data[move.to]) ^ zobrist.key(move.to, puzzle.data[move.to]);
+        }
+        return size;
+    }
+
+    uint64_t hash(const Board& board) const {return board.key;}
+
+    uint32_t tiles(const Board& board) const
+    {
+        const Puzzle& puzzle = board.puzzle;
+        return std::count_if(puzzle.data.begin(), puzzle.data.end(), [](uint8_t c) {return c != Puzzle::EMPTY;});
+    }
+
+    void count(const Board& board, color_counts& counts) const
+    {
+        counts.fill(0);
+        for (const auto c : board.puzzle.data)
+            counts[c]++;
+    }
+
+    uint32_t index(const Board&, uint32_t cell) const {return cell;}
+
+private:
+    Zobrist zobrist;
+    std::vector<uint32_t> seen;
+    uint32_t generation = 0;
+    Puzzle::move_list tile_moves;
+};
+
+template <size_t Words>
+class BitBoardBackend
+{
+public:
+    typedef BitBoard<Words> Board;
+
+    BitBoardBackend(const Puzzle& puzzle) : root(puzzle) {}
+
+    Board board(const Puzzle& puzzle) const {return Board(puzzle);}
+
+    void moves(const Board& board, std::vector<Move>& moves) const
+    {
+        moves.clear();
+
+        auto remaining = board.movable();
+        while (remaining.any())
+        {
+            uint32_t cell = remaining.lowest();
+            auto found = board.group(cell);
+            uint32_t size = found.count();
+            if (size > 1)
+                moves.push_back({cell, size});
+            remaining &= ~found;
+        }
+    }
+
+    uint32_t apply(Board& board, uint32_t cell) const {return board.match_bit(cell);}
+    uint64_t hash(const Board& board) const {return board.hash();}
+    uint32_t tiles(const Board& board) const {return board.tiles();}
+
+    void count(const Board& board, color_counts& counts) const
+    {
+        counts.fill(0);
+        for (uint8_t c = 0; c < board.colors; c++)
+            counts[c] = board.count(c);
+    }
+
+    uint32_t index(const Board& board, uint32_t cell) const {return root.index(board.bit_x(cell), board.bit_y(cell));}
+
+private:
+    const Puzzle& root;
+};
+
+template <typename Backend>
+class Search
+{
+public:
+    typedef typename Backend::Board Board;
+
+    Search(const Puzzle& puzzle, const Solver::Options& opts, SolverStats& solver_stats) :
+        root(puzzle), options(opts), stats(solver_stats), table_size(size_t(1) << opts.table_bits),
+        table(new TableEntry[size_t(1) << opts.table_bits])
+    {
+        start = std::chrono::steady_clock::now();
+
+        uint32_t threads = options.mode == Solver::EXACT ? std::max(options.threads, 1u) : 1;
+        for (uint32_t i = 0; i < threads; i++)
+            workers.emplace_back(new Worker(root, i));
+        stats.threads = threads;
+
+        best.remaining = workers[0]->backend.tiles(workers[0]->backend.board(root));
+    }
+
+    Solution run()
+    {
+        if (options.mode == Solver::EXACT)
+        {
+            if (options.warm_start_width)
+            {
+                // The beam only saw the boards it kept, its entries say nothing about their subtrees.
+                beam(*workers[0], options.warm_start_width);
+                clear_table();
+            }
+
+            exact();
+            best.complete = !aborted || proven;
+        }
+        else
+        {
+            beam(*workers[0], options.beam_width);
+        }
+
+        for (const auto& worker : workers)
+        {
+            stats.nodes += worker->nodes;
+            stats.table_probes += worker->probes;
+            stats.table_hits += worker->hits;
+        }
+        stats.seconds = elapsed();
+        return best;
+    }
+
+private:
+    // Shared by every worker without locks. check is key ^ data, so an entry torn by two writers racing
+    // fails the key comparison and reads as a miss instead of a wrong value.
+    struct TableEntry
+    {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct BeamNode
+    {
+        uint32_t parent;
+        uint32_t move;
+        uint32_t value;
+        uint32_t score;
+    };
+
+    // A child of the current beam, only materialized if it makes the cut.
+    struct BeamCandidate
+    {
+        uint64_t hash;
+        uint32_t eval;
+        uint32_t parent;
+        uint32_t move;
+        uint32_t value;
+        uint32_t score;
+    };
+
+    // Subtree handed to whichever worker gets to it first, line holds the moves that lead to board.
+    struct Task
+    {
+        Board board;
+        std::vector<uint32_t> line;
+        uint32_t value;
+        uint32_t score;
+    };
+
+    struct Worker
+    {
+        Worker(const Puzzle& root, uint32_t worker_id) : backend(root), id(worker_id), line(root.width * root.height / 2 + 1, 0) {}
+
+        Backend backend;
+        uint32_t id;
+        color_counts counts;
+
+        // Per level scratch for the exact search, deques so growing them keeps references valid.
+        // Levels are counted from the board of the current task, which is base moves into the game.
+        std::deque<Board> stack;
+        std::deque<std::vector<Move>> move_stack;
+        std::vector<uint32_t> line;
+        uint32_t base = 0;
+
+        // The owner works from the back, thieves take from the front where the biggest subtrees are.
+        std::deque<Task> tasks;
+        std::mutex tasks_lock;
+
+        uint64_t nodes = 0;
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+    };
+
+    // Subtrees deeper than this are too small to be worth handing to another thread.
+    static constexpr uint32_t SPLIT_DEPTH = 12;
+    // Workers add their node count to the shared one in batches of this many nodes.
+    static constexpr uint64_t NODE_BATCH = 1024;
+
+    uint32_t gain(uint32_t size) const {return options.objective == Solver::MAX_SCORE ? Solver::score(size) : size;}
+
+    uint32_t upper_bound(Worker& worker, const Board& board)
+    {
+        // Removing every tile of a color in a single group is the best case for both objectives.
+        worker.backend.count(board, worker.counts);
+
+        uint32_t bound = 0;
+        for (uint32_t c = 0; c < root.colors; c++)
+        {
+            if (worker.counts[c] > 1)
+                bound += gain(worker.counts[c]);
+        }
+        return bound;
+    }
+
+    uint32_t potential(const std::vector<Move>& moves) const
+    {
+        // What the groups on the board are worth if they were removed as they stand.
+        uint32_t total = 0;
+        for (const auto& move : moves)
+            total += gain(move.size);
+        return total;
+    }
+
+    void generate_moves(Worker& worker, const Board& board, std::vector<Move>& moves)
+    {
+        worker.backend.moves(board, moves);
+
+        // Biggest groups first, they score the most and find good lines early which tightens the bound.
+        std::stable_sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {return a.size > b.size;});
+    }
+
+    bool probe(Worker& worker, uint64_t hash, uint32_t value)
+    {
+        // The future of a board does not depend on how it was reached, so arriving again
+        // with no more value than before cannot lead to a better line.
+        TableEntry& entry = table[hash & (table_size - 1)];
+        worker.probes++;
+
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == hash && data >= value)
+        {
+            worker.hits++;
+            return true;
+        }
+
+        entry.data.store(value, std::memory_order_relaxed);
+        entry.check.store(hash ^ value, std::memory_order_relaxed);
+        return false;
+    }
+
+    void clear_table()
+    {
+        for (size_t i = 0; i < table_size; i++)
+        {
+            table[i].check.store(0, std::memory_order_relaxed);
+            table[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /** Records the line of worker if it beats the best one, returns true if it clears the board. */
+    bool improve(Worker& worker, uint32_t depth, uint32_t value, uint32_t score, const Board& board)
+    {
+        std::lock_guard<std::mutex> guard(best_lock);
+        if (value <= best_value.load(std::memory_order_relaxed))
+            return false;
+
+        best_value.store(value, std::memory_order_relaxed);
+        best.moves.assign(worker.line.begin(), worker.line.begin() + depth);
+        best.score = score;
+        best.remaining = worker.backend.tiles(board);
+        stats.seconds_to_best = elapsed();
+        return best.remaining == 0;
+    }
+
+    void exact()
+    {
+        Worker& first = *workers[0];
+        first.tasks.push_back({first.backend.board(root), {}, 0, 0});
+        pending = 1;
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < workers.size(); i++)
+            threads.emplace_back([this, i] {work(*workers[i]);});
+        work(first);
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    void work(Worker& worker)
+    {
+        bool waiting = false;
+        Task task{worker.backend.board(root), {}, 0, 0};
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            uint64_t seen = shared.load();
+            if (take(worker, task))
+            {
+                waiting = false;
+                explore(worker, task);
+                if (--pending == 0 || stop.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<std::mutex> guard(idle_lock);
+                    idle.notify_all();
+                }
+                continue;
+            }
+
+            if (pending == 0)
+                break;
+
+            // Nothing to steal yet, each waiting worker asks the busy ones for one subtree through the hungry count.
+            // Sleeps rather than spins so the workers with something to share keep the cores.
+            if (!waiting)
+            {
+                hungry++;
+                waiting = true;
+            }
+            std::unique_lock<std::mutex> lock(idle_lock);
+            idle.wait(lock, [this, seen] {return shared.load() != seen || pending == 0 || stop.load();});
+        }
+    }
+
+    /** Takes one request off the hungry count, false if no worker is waiting for a subtree. */
+    bool claim()
+    {
+        uint32_t requests = hungry.load(std::memory_order_relaxed);
+        while (requests > 0 && !hungry.compare_exchange_weak(requests, requests - 1, std::memory_order_relaxed))
+        {
+        }
+        return requests > 0;
+    }
+
+    bool take(Worker& worker, Task& task)
+    {
+        {
+            std::lock_guard<std::mutex> guard(worker.tasks_lock);
+            if (!worker.tasks.empty())
+            {
+                // Shared for a waiting worker that has not got to it yet, ask again for the one it was meant to get.
+                // Only the root task has no line, nobody asked for it.
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                if (!task.line.empty())
+                    hungry++;
+                return true;
+            }
+        }
+
+        for (uint32_t i = 1; i < workers.size(); i++)
+        {
+            Worker& victim = *workers[(worker.id + i) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.tasks_lock);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void share(Worker& worker, const Board& board, uint32_t depth, uint32_t value, uint32_t score, const Move& move)
+    {
+        Task task{board, std::vector<uint32_t>(worker.line.begin(), worker.line.begin() + depth + 1),
+                  value + gain(move.size), score + Solver::score(move.size)};
+        worker.backend.apply(task.board, move.cell);
+        task.line[depth] = worker.backend.index(board, move.cell);
+
+        pending++;
+        {
+            std::lock_guard<std::mutex> guard(worker.tasks_lock);
+            worker.tasks.push_back(std::move(task));
+        }
+
+        std::lock_guard<std::mutex> guard(idle_lock);
+        shared++;
+        idle.notify_one();
+    }
+
+    void explore(Worker& worker, Task& task)
+    {
+        worker.base = task.line.size();
+        std::copy(task.line.begin(), task.line.end(), worker.line.begin());
+        if (worker.stack.empty())
+            worker.stack.push_back(std::move(task.board));
+        else
+            worker.stack[0] = std::move(task.board);
+
+        search(worker, 0, task.value, task.score);
+    }
+
+    void search(Worker& worker, uint32_t level, uint32_t value, uint32_t score)
+    {
+        if (++worker.nodes % NODE_BATCH == 0)
+        {
+            uint64_t total = nodes.fetch_add(NODE_BATCH, std::memory_order_relaxed) + NODE_BATCH;
+            if (options.node_limit && total >= options.node_limit)
+            {
+                aborted = true;
+                stop = true;
+            }
+        }
+        if (stop.load(std::memory_order_relaxed))
+            return;
+
+        uint32_t depth = worker.base + level;
+        const Board& board = worker.stack[level];
+        if (value > best_value.load(std::memory_order_relaxed))
+        {
+            if (improve(worker, depth, value, score, board) && options.objective == Solver::CLEAR_BOARD)
+            {
+                proven = true;
+                stop = true;
+                return;
+            }
+        }
+
+        if (value + upper_bound(worker, board) <= best_value.load(std::memory_order_relaxed))
+            return;
+
+        if (probe(worker, worker.backend.hash(board), value))
+            return;
+
+        if (worker.move_stack.size() <= level)
+            worker.move_stack.emplace_back();
+        if (worker.stack.size() <= level + 1)
+            worker.stack.push_back(board);
+
+        auto& moves = worker.move_stack[level];
+        generate_moves(worker, board, moves);
+
+        for (uint32_t i = 0; i < moves.size(); i++)
+        {
+            const Move& move = moves[i];
+            // Young brothers wait: the first child is always searched here, so shared siblings start from its bound.
+            // Every shared subtree answers one request, a worker waiting for work gets one subtree and no more.
+            if (i > 0 && depth < SPLIT_DEPTH && hungry.load(std::memory_order_relaxed) > 0 && claim())
+            {
+                share(worker, board, depth, value, score, move);
+                continue;
+            }
+
+            Board& child = worker.stack[level + 1];
+            child = board;
+            worker.backend.apply(child, move.cell);
+            worker.line[depth] = worker.backend.index(board, move.cell);
+
+            search(worker, level + 1, value + gain(move.size), score + Solver::score(move.size));
+            if (stop.load(std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    void beam(Worker& worker, uint32_t width)
+    {
+        Backend& backend = worker.backend;
+        std::vector<std::vector<BeamNode>> layers;
+        std::vector<Board> current, next;
+        std::vector<BeamCandidate> candidates;
+        std::vector<Move> moves, child_moves;
+        Board scratch = backend.board(root);
+
+        layers.push_back({{0, 0, 0, 0}});
+        current.push_back(scratch);
+
+        uint32_t best_layer = 0, best_index = 0;
+
+        while (!current.empty())
+        {
+            const auto& layer = layers.back();
+
+            candidates.clear();
+            for (uint32_t i = 0; i < current.size(); i++)
+            {
+                const BeamNode& node = layer[i];
+                generate_moves(worker, current[i], moves);
+
+                for (const auto& move : moves)
+                {
+                    scratch = current[i];
+                    backend.apply(scratch, move.cell);
+                    worker.nodes++;
+
+                    backend.moves(scratch, child_moves);
+                    uint32_t value = node.value + gain(move.size);
+                    candidates.push_back({backend.hash(scratch), value + potential(child_moves), i, move.cell, value,
+                                          node.score + Solver::score(move.size)});
+                }
+            }
+
+            if (candidates.empty())
+                break;
+
+            // Boards reached through different move orders are the same node, keep the most valuable copy.
+            std::sort(candidates.begin(), candidates.end(), [](const BeamCandidate& a, const BeamCandidate& b)
+            {
+                return a.hash != b.hash ? a.hash < b.hash : a.value > b.value;
+            });
+            candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const BeamCandidate& a, const BeamCandidate& b)
+            {
+                return a.hash == b.hash;
+            }), candidates.end());
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this, &worker](const BeamCandidate& candidate)
+            {
+                return probe(worker, candidate.hash, candidate.value);
+            }), candidates.end());
+
+            if (candidates.size() > width)
+            {
+                std::nth_element(candidates.begin(), candidates.begin() + width, candidates.end(),
+                    [](const BeamCandidate& a, const BeamCandidate& b) {return a.eval > b.eval;});
+                candidates.resize(width);
+            }
+
+            std::vector<BeamNode> next_layer;
+            next.clear();
+            for (const auto& candidate : candidates)
+            {
+                next.push_back(current[candidate.parent]);
+                Board& child = next.back();
+                backend.apply(child, candidate.move);
+                next_layer.push_back({candidate.parent, backend.index(current[candidate.parent], candidate.move),
+                                      candidate.value, candidate.score});
+
+                if (candidate.value > best_value)
+                {
+                    best_value = candidate.value;
+                    best_layer = layers.size();
+                    best_index = next_layer.size() - 1;
+                    best.score = candidate.score;
+                    best.remaining = backend.tiles(child);
+                    stats.seconds_to_best = elapsed();
+                }
+            }
+
+            layers.push_back(std::move(next_layer));
+            std::swap(current, next);
+        }
+
+        if (best_layer == 0)
+            return;
+
+        best.moves.resize(best_layer);
+        for (uint32_t layer = best_layer, index = best_index; layer > 0; layer--)
+        {
+            const BeamNode& node = layers[layer][index];
+            best.moves[layer - 1] = node.move;
+            index = node.parent;
+        }
+    }
+
+    double elapsed() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const Puzzle& root;
+    const Solver::Options& options;
+    SolverStats& stats;
+
+    // Guards best, best_value is kept alongside for lock free bound checks.
+    std::mutex best_lock;
+    Solution best;
+    std::atomic<uint32_t> best_value{0};
+
+    std::atomic<bool> stop{false};
+    std::atomic<bool> aborted{false};
+    std::atomic<bool> proven{false};
+    std::atomic<uint64_t> nodes{0};
+    // Tasks queued or running, and requests for one from waiting workers that no task answers yet.
+    std::atomic<uint32_t> pending{0};
+    std::atomic<uint32_t> hungry{0};
+    // Waiting workers sleep on idle until a subtree is shared, the search ends or it runs out of tasks.
+    std::mutex idle_lock;
+    std::condition_variable idle;
+    std::atomic<uint64_t> shared{0};
+
+    size_t table_size;
+    std::unique_ptr<TableEntry[]> table;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::chrono::steady_clock::time_point start;
+};
+
+}
+
+Solution Solver::solve(const Puzzle& puzzle)
+{
+    // Wider bitboards are slower than Puzzle once a flood spans several words (see BitBoard),
+    // so only boards of up to 128 cells like the default 16x8 get one.
+    if (!options.force_puzzle && BitBoard<2>::fits(puzzle.width, puzzle.height, puzzle.colors))
+        return run<BitBoardBackend<2>>(puzzle, "bitboard");
+
+    return run<PuzzleBackend>(puzzle, "puzzle");
+}
+
+template <typename Backend>
+Solution Solver::run(const Puzzle& puzzle, const char* name)
+{
+    solver_stats = SolverStats();
+    solver_stats.backend = name;
+
+    Search<Backend> search(puzzle, options, solver_stats);
+    return search.run();
+}
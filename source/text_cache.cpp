@@ -0,0 +1,137 @@
+#include "text_cache.hpp"
+
+#include <cstdio>
+
+static constexpr const char* DIGITS = "0123456789";
+
+TextCache::TextCache(SDL_Renderer* renderer, const AtlasFont& font, const SDL_Color& color) : renderer(renderer),
+    font(font), color(color), height(font.height())
+{
+    texts.reserve(MAX_TEXTS);
+}
+
+TextCache::~TextCache()
+{
+    clear();
+}
+
+int TextCache::draw(int x, int y, std::string_view text)
+{
+    draws++;
+    Text* entry = nullptr;
+    for (auto& cached : texts)
+    {
+        if (cached.text == text)
+        {
+            entry = &cached;
+            break;
+        }
+    }
+
+    if (!entry)
+    {
+        if (texts.size() < MAX_TEXTS)
+        {
+            texts.push_back({});
+            entry = &texts.back();
+        }
+        else
+        {
+            // The text drawn the longest ago makes room.
+            entry = &texts[0];
+            for (auto& cached : texts)
+                if (cached.last_drawn < entry->last_drawn)
+                    entry = &cached;
+            if (entry->texture) SDL_DestroyTexture(entry->texture);
+        }
+
+        entry->text = text;
+        entry->width = font.width(entry->text);
+        entry->texture = render(entry->text.c_str(), entry->width);
+    }
+    entry->last_drawn = draws;
+
+    calls++;
+    if (!entry->texture)
+        return font.draw(renderer, x, y, entry->text, color);
+
+    SDL_Rect rect = {x, y, entry->width, height};
+    SDL_RenderCopy(renderer, entry->texture, nullptr, &rect);
+    return entry->width;
+}
+
+int TextCache::draw_number(int x, int y, uint32_t value)
+{
+    if (!strip_rendered)
+    {
+        // Widths of every prefix of the strip, so the digits keep the spacing the font gives them in a row.
+        for (int i = 0; i <= 10; i++)
+            digit_x[i] = font.width(std::string_view(DIGITS, i));
+        digits = render(DIGITS, digit_x[10]);
+        strip_rendered = true;
+    }
+
+    if (!digits)
+    {
+        calls++;
+        return font.draw(renderer, x, y, std::to_string(value), color);
+    }
+
+    char number[10];
+    int count = 0;
+    do
+    {
+        number[count++] = value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    int left = x;
+    while (count-- > 0)
+    {
+        int digit = number[count];
+        int width = digit_x[digit + 1] - digit_x[digit];
+        SDL_Rect source = {digit_x[digit], 0, width, height};
+        SDL_Rect rect = {left, y, width, height};
+        SDL_RenderCopy(renderer, digits, &source, &rect);
+        calls++;
+        left += width;
+    }
+    return left - x;
+}
+
+void TextCache::clear()
+{
+    for (auto& cached : texts)
+        if (cached.texture) SDL_DestroyTexture(cached.texture);
+    texts.clear();
+    if (digits) SDL_DestroyTexture(digits);
+    digits = nullptr;
+    strip_rendered = false;
+}
+
+SDL_Texture* TextCache::render(const char* text, int width)
+{
+    if (width <= 0)
+        return nullptr;
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture)
+    {
+        printf("SDL_CreateTexture: %s\n", SDL_GetError());
+        return nullptr;
+    }
+
+    // Glyphs blended over transparent black leave their color multiplied by their alpha, the texture is drawn as such.
+    SDL_SetTextureBlendMode(texture, SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+        SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD));
+
+    SDL_Texture* target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    font.draw(renderer, 0, 0, text, color);
+    SDL_SetRenderTarget(renderer, target);
+
+    rendered++;
+    return texture;
+}
@@ -0,0 +1,130 @@
+#include "tile_animation.hpp"
+
+#include <algorithm>
+
+void TileAnimation::reset(uint32_t w, uint32_t h)
+{
+    width = w;
+    height = h;
+    from_x.clear();
+    from_y.clear();
+    dx.clear();
+    dy.clear();
+    progress.clear();
+    step.clear();
+    colors.clear();
+    target.clear();
+    tween_of.assign(w * h, NONE);
+    reset_landed();
+}
+
+void TileAnimation::start(const Puzzle& puzzle, const Puzzle::move_list& moves, uint32_t ticks)
+{
+    // Every lookup happens before any tween changes, a tile may be moving to the cell another one leaves.
+    continued.clear();
+    for (const auto& move : moves)
+        continued.push_back(tween_of[move.from]);
+    for (const auto& move : moves)
+        tween_of[move.from] = NONE;
+
+    const float speed = 1.0f / std::max(ticks, 1u);
+    for (size_t m = 0; m < moves.size(); m++)
+    {
+        const auto& move = moves[m];
+        uint32_t i = continued[m];
+        if (move.to == Puzzle::REMOVED)
+        {
+            // Removed mid flight, marked here and dropped below so the indices in continued stay valid.
+            if (i != NONE)
+                target[i] = NONE;
+            continue;
+        }
+
+        float x = puzzle.cell_x(move.from);
+        float y = puzzle.cell_y(move.from);
+        if (i != NONE)
+        {
+            x = this->x(i, 0);
+            y = this->y(i, 0);
+        }
+        else
+        {
+            i = progress.size();
+            from_x.push_back(0);
+            from_y.push_back(0);
+            dx.push_back(0);
+            dy.push_back(0);
+            progress.push_back(0);
+            step.push_back(0);
+            colors.push_back(0);
+            target.push_back(0);
+        }
+
+        from_x[i] = x;
+        from_y[i] = y;
+        dx[i] = puzzle.cell_x(move.to) - x;
+        dy[i] = puzzle.cell_y(move.to) - y;
+        progress[i] = 0;
+        step[i] = speed;
+        colors[i] = puzzle.data[move.to];
+        target[i] = move.to;
+        tween_of[move.to] = i;
+    }
+
+    for (uint32_t i = progress.size(); i-- > 0;)
+        if (target[i] == NONE)
+            remove(i);
+}
+
+void TileAnimation::update()
+{
+    const uint32_t count = progress.size();
+    uint32_t done = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        progress[i] = std::min(progress[i] + step[i], 1.0f);
+        done += progress[i] >= 1.0f;
+    }
+
+    if (done == 0)
+        return;
+
+    for (uint32_t i = count; i-- > 0;)
+    {
+        if (progress[i] < 1.0f)
+            continue;
+        uint32_t x = target[i] / height;
+        landed_minx = std::min(landed_minx, x);
+        landed_maxx = std::max(landed_maxx, x);
+        tween_of[target[i]] = NONE;
+        remove(i);
+    }
+}
+
+void TileAnimation::remove(uint32_t i)
+{
+    // The last tween takes its place.
+    uint32_t last = progress.size() - 1;
+    if (i != last)
+    {
+        from_x[i] = from_x[last];
+        from_y[i] = from_y[last];
+        dx[i] = dx[last];
+        dy[i] = dy[last];
+        progress[i] = progress[last];
+        step[i] = step[last];
+        colors[i] = colors[last];
+        target[i] = target[last];
+        if (target[i] != NONE)
+            tween_of[target[i]] = i;
+    }
+
+    from_x.pop_back();
+    from_y.pop_back();
+    dx.pop_back();
+    dy.pop_back();
+    progress.pop_back();
+    step.pop_back();
+    colors.pop_back();
+    target.pop_back();
+}
@@ -0,0 +1,33 @@
+#include "tile_image.hpp"
+
+#include <algorithm>
+
+constexpr uint32_t BLACK = 0x000000FF;
+
+void TileImage::reset(uint32_t w, uint32_t h)
+{
+    width = w;
+    height = h;
+    image.assign(w * h, BLACK);
+}
+
+void TileImage::update(const Puzzle& puzzle, const BoardMesh::palette& colors, uint32_t minx, uint32_t maxx)
+{
+    uint32_t pixel[256];
+    std::fill(pixel, pixel + 256, BLACK);
+    for (size_t c = 0; c < colors.size() && c < Puzzle::EMPTY; c++)
+    {
+        auto [r, g, b] = colors[c];
+        pixel[c] = static_cast<uint32_t>(r) << 24 | g << 16 | b << 8 | 0xFF;
+    }
+
+    // The board is stored column by column and the image row by row, each column is written down the image.
+    maxx = std::min(maxx, width - 1);
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        const uint8_t* column = &puzzle.data[puzzle.index(x, 0)];
+        uint32_t* out = &image[x];
+        for (uint32_t y = 0; y < height; y++, out += width)
+            *out = pixel[column[y]];
+    }
+}
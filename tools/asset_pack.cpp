@@ -0,0 +1,269 @@
+// Decodes the game's images and rasterizes the glyphs of its font into an asset pack, so the game makes textures
+// straight from the pack instead of decoding PNG and TrueType on the console at startup. Fonts are rasterized the
+// way SDL_ttf renders them blended, printable ASCII only, into an atlas of white glyphs with their coverage as alpha.
+//
+// Also times what startup used to spend decoding the inputs ("decode") against reading the pack ("load"). Both
+// leave the pixels ready for SDL_CreateTexture, which is not timed.
+//
+// Usage: asset_pack [-o pack] [-s font_size] [-r repeats] [name=file.png | name=file.ttf ...]
+//   Without files it packs the cursor and the font the game uses into ../romfs/assets.pack, where the game looks.
+#include "asset_pack.hpp"
+#include "bench_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include <png.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// First and last characters put in a font's atlas.
+constexpr uint16_t FIRST_CHAR = 32;
+constexpr uint16_t LAST_CHAR = 126;
+// Width of a font's atlas, glyphs are laid out in rows as tall as their tallest.
+constexpr uint32_t ATLAS_WIDTH = 512;
+
+static uint32_t rgba8888(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    return static_cast<uint32_t>(r) << 24 | g << 16 | b << 8 | a;
+}
+
+static bool load_png(const char* filename, AssetImage& image)
+{
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&png, filename))
+        return false;
+
+    png.format = PNG_FORMAT_RGBA;
+    std::vector<uint8_t> bytes(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, bytes.data(), 0, nullptr))
+        return false;
+
+    image.width = png.width;
+    image.height = png.height;
+    image.pixels.resize(size_t(png.width) * png.height);
+    for (size_t i = 0; i < image.pixels.size(); i++)
+        image.pixels[i] = rgba8888(bytes[4 * i], bytes[4 * i + 1], bytes[4 * i + 2], bytes[4 * i + 3]);
+    return true;
+}
+
+// 26.6 fixed point rounded up to whole pixels, as SDL_ttf does.
+static int ceil_pixels(FT_Pos value)
+{
+    return (value + 63) >> 6;
+}
+
+static bool load_font(FT_Library library, const char* filename, uint32_t size, AssetImage& image)
+{
+    FT_Face face;
+    if (FT_New_Face(library, filename, 0, &face) != 0)
+        return false;
+    if (FT_Set_Char_Size(face, 0, size * 64, 0, 0) != 0)
+    {
+        FT_Done_Face(face);
+        return false;
+    }
+
+    const FT_Fixed scale = face->size->metrics.y_scale;
+    const int ascent = ceil_pixels(FT_MulFix(face->ascender, scale));
+    const int descent = ceil_pixels(FT_MulFix(face->descender, scale));
+
+    struct Bitmap
+    {
+        std::vector<uint8_t> coverage;
+        AssetGlyph glyph;
+    };
+    std::vector<Bitmap> bitmaps(LAST_CHAR - FIRST_CHAR + 1);
+    for (uint16_t c = FIRST_CHAR; c <= LAST_CHAR; c++)
+    {
+        Bitmap& bitmap = bitmaps[c - FIRST_CHAR];
+        bitmap.glyph = {};
+        if (FT_Load_Char(face, c, FT_LOAD_DEFAULT) != 0 || FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0)
+            continue;
+
+        const FT_GlyphSlot slot = face->glyph;
+        bitmap.glyph.width = slot->bitmap.width;
+        bitmap.glyph.height = slot->bitmap.rows;
+        bitmap.glyph.left = slot->bitmap_left;
+        bitmap.glyph.top = ascent - slot->bitmap_top;
+        bitmap.glyph.advance = ceil_pixels(slot->metrics.horiAdvance);
+        bitmap.coverage.resize(size_t(slot->bitmap.width) * slot->bitmap.rows);
+        for (uint32_t y = 0; y < slot->bitmap.rows; y++)
+            memcpy(&bitmap.coverage[y * slot->bitmap.width], slot->bitmap.buffer + y * slot->bitmap.pitch,
+                   slot->bitmap.width);
+    }
+    FT_Done_Face(face);
+
+    // Tallest first, a pixel apart so scaled text never samples a neighbour.
+    std::vector<uint32_t> order(bitmaps.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&bitmaps](uint32_t a, uint32_t b)
+    {
+        return bitmaps[a].glyph.height > bitmaps[b].glyph.height;
+    });
+
+    uint32_t x = 1, y = 1, row_height = 0;
+    for (uint32_t i : order)
+    {
+        AssetGlyph& glyph = bitmaps[i].glyph;
+        if (glyph.width == 0)
+            continue;
+        if (glyph.width + 2u > ATLAS_WIDTH)
+            return false;
+        if (x + glyph.width + 1 > ATLAS_WIDTH)
+        {
+            x = 1;
+            y += row_height + 1;
+            row_height = 0;
+        }
+        glyph.x = x;
+        glyph.y = y;
+        x += glyph.width + 1;
+        row_height = std::max<uint32_t>(row_height, glyph.height);
+    }
+
+    image.width = ATLAS_WIDTH;
+    image.height = y + row_height + 1;
+    image.pixels.assign(size_t(image.width) * image.height, rgba8888(255, 255, 255, 0));
+    image.glyphs.clear();
+    for (const auto& bitmap : bitmaps)
+    {
+        const AssetGlyph& glyph = bitmap.glyph;
+        for (uint32_t row = 0; row < glyph.height; row++)
+            for (uint32_t column = 0; column < glyph.width; column++)
+                image.pixels[(glyph.y + row) * image.width + glyph.x + column] =
+                    rgba8888(255, 255, 255, bitmap.coverage[row * glyph.width + column]);
+        image.glyphs.push_back(glyph);
+    }
+    image.first_char = FIRST_CHAR;
+    image.line_height = ascent - descent + 1;
+    return true;
+}
+
+static bool ends_with(const std::string& text, const char* suffix)
+{
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+static bool load_all(FT_Library library, const std::vector<std::pair<std::string, std::string>>& inputs,
+                     uint32_t font_size, std::vector<AssetImage>& images)
+{
+    images.clear();
+    for (const auto& [name, filename] : inputs)
+    {
+        AssetImage image;
+        image.name = name;
+        bool ok = ends_with(filename, ".ttf") ? load_font(library, filename.c_str(), font_size, image)
+                                              : load_png(filename.c_str(), image);
+        if (!ok)
+        {
+            fprintf(stderr, "Could not load %s\n", filename.c_str());
+            return false;
+        }
+        images.push_back(std::move(image));
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filename = "../romfs/assets.pack";
+    uint32_t font_size = 60, repeats = 20;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:s:r:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': filename = optarg; break;
+            case 's': font_size = std::max(atoi(optarg), 1); break;
+            case 'r': repeats = std::max(atoi(optarg), 1); break;
+            default:
+                fprintf(stderr, "Usage: %s [-o pack] [-s font_size] [-r repeats] [name=file.png | name=file.ttf ...]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> inputs;
+    for (int i = optind; i < argc; i++)
+    {
+        const char* equals = strchr(argv[i], '=');
+        if (!equals)
+        {
+            fprintf(stderr, "Expected name=file, got %s\n", argv[i]);
+            return 1;
+        }
+        inputs.emplace_back(std::string(argv[i], equals - argv[i]), equals + 1);
+    }
+    if (inputs.empty())
+        inputs = {{"cursor", "../assets/graphics/cursor.png"}, {"font", "../assets/fonts/FreeSans.ttf"}};
+
+    FT_Library library;
+    if (FT_Init_FreeType(&library) != 0)
+    {
+        fprintf(stderr, "Could not start FreeType\n");
+        return 1;
+    }
+
+    std::vector<AssetImage> images;
+    double decode_time = 0;
+    for (uint32_t i = 0; i < repeats; i++)
+    {
+        auto start = steady_clock::now();
+        if (!load_all(library, inputs, font_size, images))
+            return 1;
+        decode_time += microseconds_since(start);
+    }
+    FT_Done_FreeType(library);
+
+    if (!AssetPack::write(filename, images))
+    {
+        fprintf(stderr, "Could not write %s\n", filename);
+        return 1;
+    }
+
+    // Read back the way the game does, every image has to come out as it went in.
+    AssetPack pack;
+    double load_time = 0;
+    for (uint32_t i = 0; i < repeats; i++)
+    {
+        auto start = steady_clock::now();
+        if (!pack.open(filename))
+        {
+            fprintf(stderr, "Could not read back %s\n", filename);
+            return 1;
+        }
+        load_time += microseconds_since(start);
+    }
+
+    for (const auto& image : images)
+    {
+        const AssetEntry* entry = pack.find(image.name);
+        if (!entry || entry->width != image.width || entry->height != image.height ||
+            !std::equal(image.pixels.begin(), image.pixels.end(), pack.pixels(*entry)) ||
+            entry->glyph_count != image.glyphs.size() ||
+            memcmp(pack.glyphs(*entry), image.glyphs.data(), image.glyphs.size() * sizeof(AssetGlyph)) != 0)
+        {
+            fprintf(stderr, "%s reads back wrong from %s\n", image.name.c_str(), filename);
+            return 1;
+        }
+        printf("%-8s %4ux%-4u", image.name.c_str(), image.width, image.height);
+        if (!image.glyphs.empty())
+            printf("  %zu glyphs, %u px lines", image.glyphs.size(), image.line_height);
+        printf("\n");
+    }
+
+    printf("decode   %.0f us\n", decode_time / repeats);
+    printf("load     %.0f us\n", load_time / repeats);
+    printf("wrote    %s (%zu bytes)\n", filename, pack.size());
+    return 0;
+}
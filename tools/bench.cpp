@@ -0,0 +1,302 @@
+// Regression benchmarks for the puzzle core: dealing, group queries, matches, compaction and whole random games
+// on a few board sizes and color counts. Writes the results as JSON and compares them with a baseline written
+// by an earlier run, failing when something got slower than the tolerance allows.
+//
+// Usage: bench [-o results.json] [-b baseline.json] [-t percent] [-m ms]
+//   -o   write the results as JSON to this file, - for stdout
+//   -b   compare with the results of an earlier run, exits 1 if any is more than -t percent slower (default 10)
+//   -m   time each benchmark for at least this many milliseconds (default 200)
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef std::pair<uint32_t, uint32_t> move;
+
+static volatile uint32_t sink = 0;
+
+struct Result
+{
+    std::string name;
+    double ns;
+    uint64_t ops;
+};
+
+struct Pass
+{
+    uint64_t ops;
+    double ns;
+};
+
+// Repeats pass, which does some operations and returns how many and the time they took, for at least min_ns.
+// The time is split in ROUNDS and the fastest round is reported, which keeps other load on the host out of the numbers.
+template <typename Body>
+static Result run(const std::string& name, double min_ns, Body pass)
+{
+    constexpr int ROUNDS = 5;
+    uint64_t ops = 0;
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        Pass total{0, 0};
+        while (total.ns < min_ns / ROUNDS)
+        {
+            Pass done = pass();
+            total.ops += done.ops;
+            total.ns += done.ns;
+        }
+        ops += total.ops;
+        if (round == 0 || total.ns / total.ops < best)
+            best = total.ns / total.ops;
+    }
+    return {name, best, ops};
+}
+
+// For passes timed as a whole.
+template <typename Body>
+static Pass timed(Body body)
+{
+    auto start = steady_clock::now();
+    uint64_t ops = body();
+    return {ops, nanoseconds_since(start)};
+}
+
+// Plays a random game to the end, returns its moves.
+static std::vector<move> playout(Puzzle& puzzle, Random& random)
+{
+    std::vector<move> moves;
+    uint32_t x, y;
+    while (puzzle.random_move(random, x, y))
+    {
+        puzzle.match(x, y);
+        moves.emplace_back(x, y);
+    }
+    return moves;
+}
+
+static std::vector<Result> bench_board(uint32_t width, uint32_t height, uint8_t colors, double min_ns)
+{
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "/%ux%u/%u", width, height, colors);
+    std::vector<Result> results;
+
+    Puzzle puzzle(width, height, colors, 1);
+    results.push_back(run(std::string("randomize") + prefix, min_ns, [&]()
+    {
+        return timed([&]()
+        {
+            puzzle.randomize();
+            sink += puzzle.has_moves();
+            return 1;
+        });
+    }));
+
+    // Group queries on every cell of a fresh board.
+    const Puzzle board(width, height, colors, 1);
+    results.push_back(run(std::string("test") + prefix, min_ns, [&]()
+    {
+        return timed([&]()
+        {
+            for (uint32_t x = 0; x < width; x++)
+                for (uint32_t y = 0; y < height; y++)
+                    sink += board.test(x, y).size();
+            return width * height;
+        });
+    }));
+
+    // The same few games are replayed for match and compact, so both see the boards of real games.
+    std::vector<std::vector<move>> games;
+    Random random(1);
+    for (uint32_t seed = 1; seed <= 4; seed++)
+    {
+        Puzzle game(width, height, colors, seed);
+        games.push_back(playout(game, random));
+    }
+
+    // Dealing the boards again is not timed.
+    results.push_back(run(std::string("match") + prefix, min_ns, [&]()
+    {
+        Pass pass{0, 0};
+        for (uint32_t seed = 1; seed <= games.size(); seed++)
+        {
+            Puzzle game(width, height, colors, seed);
+            Pass done = timed([&]()
+            {
+                for (const auto& [x, y] : games[seed - 1])
+                    sink += game.match(x, y);
+                return games[seed - 1].size();
+            });
+            pass.ops += done.ops;
+            pass.ns += done.ns;
+        }
+        return pass;
+    }));
+
+    // compact is timed on its own, the group query and emptying of the cells before it are not.
+    Puzzle::cell_list group;
+    results.push_back(run(std::string("compact") + prefix, min_ns, [&]()
+    {
+        Pass pass{0, 0};
+        for (uint32_t seed = 1; seed <= games.size(); seed++)
+        {
+            Puzzle game(width, height, colors, seed);
+            for (const auto& [x, y] : games[seed - 1])
+            {
+                const auto& matched = game.test(x, y);
+                group.assign(matched.begin(), matched.end());
+                for (const auto cell : group)
+                    game.data[cell] = Puzzle::EMPTY;
+
+                pass.ns += timed([&]() {game.compact(group); return 1;}).ns;
+            }
+            pass.ops += games[seed - 1].size();
+        }
+        return pass;
+    }));
+
+    // Whole games from dealing to the last move, picking moves with the group labels.
+    uint64_t seed = 1;
+    results.push_back(run(std::string("playout") + prefix, min_ns, [&]()
+    {
+        return timed([&]()
+        {
+            Puzzle game(width, height, colors, seed);
+            Random moves(seed++);
+            sink += playout(game, moves).size();
+            return 1;
+        });
+    }));
+
+    return results;
+}
+
+// Reads the results written by write_json. Only that layout is understood, one result per line.
+static bool read_json(const char* filename, std::vector<Result>& results)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+        return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[128];
+        double ns;
+        unsigned long long ops;
+        if (sscanf(line, " {\"name\": \"%127[^\"]\", \"ns\": %lf, \"ops\": %llu}", name, &ns, &ops) == 3)
+            results.push_back({name, ns, ops});
+    }
+
+    fclose(file);
+    return true;
+}
+
+static bool write_json(FILE* file, const std::vector<Result>& results)
+{
+    fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        fprintf(file, "    {\"name\": \"%s\", \"ns\": %.1f, \"ops\": %llu}%s\n", results[i].name.c_str(), results[i].ns,
+                static_cast<unsigned long long>(results[i].ops), i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return !ferror(file);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* output = nullptr;
+    const char* baseline_file = nullptr;
+    double tolerance = 10;
+    double min_ms = 200;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:b:t:m:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': output = optarg; break;
+            case 'b': baseline_file = optarg; break;
+            case 't': tolerance = atof(optarg); break;
+            case 'm': min_ms = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-o results.json] [-b baseline.json] [-t percent] [-m ms]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    std::vector<Result> baseline;
+    if (baseline_file && !read_json(baseline_file, baseline))
+    {
+        fprintf(stderr, "Could not read %s\n", baseline_file);
+        return 1;
+    }
+
+    // Progress goes to stderr when the JSON goes to stdout.
+    FILE* report = output && strcmp(output, "-") == 0 ? stderr : stdout;
+    fprintf(report, "%-24s %12s %10s", "benchmark", "ns/op", "ops");
+    if (baseline_file)
+        fprintf(report, " %12s %8s", "baseline", "change");
+    fprintf(report, "\n");
+
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {128, 128}};
+    // Lets the CPU leave its idle clocks before the first benchmark is timed.
+    bench_board(16, 8, 4, min_ms * 1e6);
+    std::vector<Result> results;
+    uint32_t regressions = 0;
+    for (const auto& [width, height] : sizes)
+    {
+        for (uint8_t colors : {3, 4, 6})
+        {
+            for (const auto& result : bench_board(width, height, colors, min_ms * 1e6))
+            {
+                fprintf(report, "%-24s %12.1f %10llu", result.name.c_str(), result.ns,
+                        static_cast<unsigned long long>(result.ops));
+
+                auto old = std::find_if(baseline.begin(), baseline.end(),
+                                        [&result](const Result& entry) {return entry.name == result.name;});
+                if (old != baseline.end())
+                {
+                    double change = (result.ns / old->ns - 1) * 100;
+                    bool slower = change > tolerance;
+                    regressions += slower;
+                    fprintf(report, " %12.1f %+7.1f%%%s", old->ns, change, slower ? "  SLOWER" : "");
+                }
+                else if (baseline_file)
+                    fprintf(report, " %12s", "-");
+                fprintf(report, "\n");
+                fflush(report);
+
+                results.push_back(result);
+            }
+        }
+    }
+
+    if (output)
+    {
+        bool to_stdout = strcmp(output, "-") == 0;
+        FILE* file = to_stdout ? stdout : fopen(output, "w");
+        if (!file || !write_json(file, results))
+        {
+            fprintf(stderr, "Could not write %s\n", output);
+            return 1;
+        }
+        if (!to_stdout)
+            fclose(file);
+    }
+
+    if (regressions)
+    {
+        fprintf(report, "%u benchmarks more than %.0f%% slower than the baseline\n", regressions, tolerance);
+        return 1;
+    }
+
+    return 0;
+}
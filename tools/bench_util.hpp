@@ -0,0 +1,24 @@
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <chrono>
+
+/** Clock every host tool times with. */
+typedef std::chrono::steady_clock steady_clock;
+
+inline double seconds_since(steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(steady_clock::now() - start).count();
+}
+
+inline double microseconds_since(steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(steady_clock::now() - start).count();
+}
+
+inline double nanoseconds_since(steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(steady_clock::now() - start).count();
+}
+
+#endif
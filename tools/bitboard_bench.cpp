@@ -0,0 +1,137 @@
+// Compares BitBoard against the byte array Puzzle for group queries and random playouts.
+//
+// Usage: bitboard_bench [playouts]
+#include "bench_util.hpp"
+#include "bitboard.hpp"
+#include "puzzle.hpp"
+#include "solver.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static volatile uint32_t sink = 0;
+
+// One cell per group of two or more, in the same order for both representations (column by column, bottom up).
+static void moves(const Puzzle& puzzle, std::vector<std::pair<uint32_t, uint32_t>>& moves, std::vector<uint32_t>& seen)
+{
+    moves.clear();
+    std::fill(seen.begin(), seen.end(), 0);
+    for (uint32_t x = 0; x < puzzle.width; x++)
+    {
+        for (uint32_t y = puzzle.height; y-- > 0;)
+        {
+            if (puzzle.group_size(x, y) < 2 || seen[puzzle.label(x, y)])
+                continue;
+            seen[puzzle.label(x, y)] = 1;
+            moves.push_back({x, y});
+        }
+    }
+}
+
+template <size_t Words>
+static void moves(const BitBoard<Words>& board, std::vector<std::pair<uint32_t, uint32_t>>& moves)
+{
+    moves.clear();
+    auto remaining = board.movable();
+    while (remaining.any())
+    {
+        uint32_t cell = remaining.lowest();
+        auto found = board.group(cell);
+        if (found.count() > 1)
+            moves.push_back({board.bit_x(cell), board.bit_y(cell)});
+        remaining &= ~found;
+    }
+}
+
+template <typename Board, typename Moves>
+static uint32_t playout(Board& board, uint32_t seed, Moves&& list_moves)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> options;
+    uint32_t score = 0;
+    while (true)
+    {
+        list_moves(board, options);
+        if (options.empty())
+            return score;
+        auto [x, y] = options[seed % options.size()];
+        seed = seed * 1103515245 + 12345;
+        score += Solver::score(board.match(x, y));
+    }
+}
+
+template <size_t Words>
+static void compare(uint32_t width, uint32_t height, uint8_t colors, uint32_t playouts)
+{
+    Puzzle puzzle(width, height, colors, 3);
+    BitBoard<Words> bits(puzzle);
+    std::vector<uint32_t> seen(width * height);
+
+    // Both representations have to agree on every move of a playout before their speed means anything.
+    bool agree = true;
+    {
+        Puzzle a = puzzle;
+        BitBoard<Words> b = bits;
+        std::vector<std::pair<uint32_t, uint32_t>> list_a, list_b;
+        for (uint32_t seed = 1; agree; seed = seed * 1103515245 + 12345)
+        {
+            moves(a, list_a, seen);
+            moves(b, list_b);
+            agree = list_a == list_b;
+            if (!agree || list_a.empty())
+                break;
+            auto [x, y] = list_a[seed % list_a.size()];
+            agree = a.match(x, y) == b.match(x, y);
+            for (uint32_t i = 0; agree && i < width; i++)
+                for (uint32_t j = 0; agree && j < height; j++)
+                    agree = a.at(i, j) == b.at(i, j);
+        }
+    }
+
+    const uint32_t queries = 200000;
+    auto start = steady_clock::now();
+    for (uint32_t i = 0; i < queries; i++)
+        sink += puzzle.test(i % width, i / width % height).size();
+    double puzzle_queries = queries / seconds_since(start);
+
+    start = steady_clock::now();
+    for (uint32_t i = 0; i < queries; i++)
+        sink += bits.test(i % width, i / width % height).count();
+    double bit_queries = queries / seconds_since(start);
+
+    start = steady_clock::now();
+    for (uint32_t i = 0; i < playouts; i++)
+    {
+        Puzzle copy = puzzle;
+        sink += playout(copy, i, [&seen](const Puzzle& board, auto& list) {moves(board, list, seen);});
+    }
+    double puzzle_playouts = playouts / seconds_since(start);
+
+    start = steady_clock::now();
+    for (uint32_t i = 0; i < playouts; i++)
+    {
+        BitBoard<Words> copy = bits;
+        sink += playout(copy, i, [](const BitBoard<Words>& board, auto& list) {moves(board, list);});
+    }
+    double bit_playouts = playouts / seconds_since(start);
+
+    char board[32];
+    snprintf(board, sizeof(board), "%ux%u", width, height);
+    printf("%-8s %6u %5zu %12.0f %12.0f %6.1fx %12.0f %12.0f %6.1fx%s\n", board, colors, Words,
+           puzzle_queries, bit_queries, bit_queries / puzzle_queries,
+           puzzle_playouts, bit_playouts, bit_playouts / puzzle_playouts, agree ? "" : "  (boards differ!)");
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t playouts = argc > 1 ? atoi(argv[1]) : 2000;
+
+    printf("%-8s %6s %5s %12s %12s %7s %12s %12s %7s\n", "board", "colors", "words",
+           "puzzle q/s", "bits q/s", "", "puzzle p/s", "bits p/s", "");
+    compare<2>(16, 8, 4, playouts);
+    compare<2>(16, 8, 6, playouts);
+    compare<2>(10, 10, 4, playouts);
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Measures drawing a 1000x1000 board through the camera at several zoom levels, in a 1920x960 view as in the game.
+// A frame pans the camera a little and builds the mesh of the tiles in view, as the game does for boards too large
+// for a texture. "in view" is the tiles the camera shows and "frame us" the time to build their mesh. Zoomed out past
+// LOD_TILE the game draws a pixel a tile image instead: "image us" updates the columns a move changed, the whole
+// image once when first zoomed out ("full image us"). "all tiles us" builds every tile of the board, for comparison.
+//
+// Usage: camera_bench [frames]
+#include "bench_util.hpp"
+#include "board_mesh.hpp"
+#include "camera.hpp"
+#include "puzzle.hpp"
+#include "tile_image.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Same as the game.
+constexpr float VIEW_WIDTH = 1920;
+constexpr float VIEW_HEIGHT = 960;
+constexpr float TILE_SIZE = 120;
+constexpr float LOD_TILE = 8;
+
+static volatile uint32_t sink = 0;
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames = argc > 1 ? atoi(argv[1]) : 200;
+    const uint32_t width = 1000, height = 1000;
+    const BoardMesh::palette colors = {{200, 64, 64}, {64, 200, 64}, {64, 64, 200}, {200, 200, 64}};
+
+    Puzzle puzzle(width, height, 4, 1);
+    BoardMesh mesh;
+
+    auto start = steady_clock::now();
+    mesh.add_columns(puzzle, colors, 1, 0, width - 1);
+    double all_tiles = microseconds_since(start);
+
+    TileImage image;
+    image.reset(width, height);
+    start = steady_clock::now();
+    image.update(puzzle, colors, 0, width - 1);
+    double full_image = microseconds_since(start);
+
+    // The columns a move changes, over a few random moves.
+    Random random(1);
+    double image_time = 0;
+    uint32_t moves = 0;
+    puzzle.reset_changes();
+    while (moves < 100 && puzzle.has_moves())
+    {
+        uint32_t x = random.below(width), y = random.below(height);
+        if (puzzle.group_size(x, y) < 2)
+            continue;
+        puzzle.match(x, y);
+        auto [minx, maxx] = puzzle.changes();
+        start = steady_clock::now();
+        image.update(puzzle, colors, minx, maxx);
+        image_time += microseconds_since(start);
+        puzzle.reset_changes();
+        moves++;
+    }
+    sink += image.pixels()[0];
+
+    printf("1000x1000, all tiles %.0f us, full image %.0f us, image %.1f us a move\n", all_tiles, full_image,
+           image_time / moves);
+    printf("%-8s %10s %10s %10s\n", "tile px", "in view", "quads", "frame us");
+    for (float tile : {120.0f, 32.0f, 16.0f, 8.0f, 4.0f, 0.0f})
+    {
+        Camera camera;
+        camera.reset(width, height, VIEW_WIDTH, VIEW_HEIGHT, TILE_SIZE);
+        camera.zoom(tile / TILE_SIZE, VIEW_WIDTH / 2, VIEW_HEIGHT / 2);
+
+        double frame_time = 0;
+        uint64_t in_view = 0, quads = 0;
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            start = steady_clock::now();
+            camera.pan(i % 2 ? 7 : -5, 3);
+            uint32_t minx = camera.min_x(), maxx = camera.max_x(), miny = camera.min_y(), maxy = camera.max_y();
+            if (camera.tile() >= LOD_TILE)
+            {
+                mesh.clear();
+                mesh.set_origin(camera.screen_x(0), camera.screen_y(0));
+                mesh.set_bounds(minx, maxx, miny, maxy);
+                mesh.add_columns(puzzle, colors, camera.tile(), minx, maxx);
+            }
+            frame_time += microseconds_since(start);
+            in_view += uint64_t(maxx - minx + 1) * (maxy - miny + 1);
+            quads += camera.tile() >= LOD_TILE ? mesh.quads() : 0;
+        }
+
+        printf("%-8.2f %10.0f %10.0f %10.1f%s\n", camera.tile(), double(in_view) / frames, double(quads) / frames,
+               frame_time / frames, camera.tile() < LOD_TILE ? "  (image)" : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Checks that new games keep dealing different catalog boards. Plays many presses of "new game" the way the game
+// does: a catalog seed is picked with a generator seeded once, then the game reseeds its own generator with the
+// seed and draws the palette from it. The picks have to cover nearly the whole difficulty, as uniform draws do.
+//
+// Usage: catalog_test [presses]
+#include "random.hpp"
+#include "seed_catalog.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Same as the game.
+static const uint32_t WIDTH = 16, HEIGHT = 8, COLORS = 4;
+
+int main(int argc, char* argv[])
+{
+    uint32_t presses = argc > 1 ? atoi(argv[1]) : 2000;
+    const char* filename = "build/catalog_test.bin";
+    const uint32_t sizes[SeedCatalog::DIFFICULTIES] = {569, 300, 40, 10};
+
+    std::vector<SeedEntry> entries;
+    uint32_t seed = 1;
+    for (uint8_t difficulty = 0; difficulty < SeedCatalog::DIFFICULTIES; difficulty++)
+        for (uint32_t i = 0; i < sizes[difficulty]; i++)
+            entries.push_back({seed++, 0, 0, difficulty, 0});
+    SeedCatalog catalog;
+    if (!SeedCatalog::write(filename, entries, WIDTH, HEIGHT, COLORS) || !catalog.open(filename))
+    {
+        fprintf(stderr, "Could not write %s\n", filename);
+        return 1;
+    }
+
+    bool ok = true;
+    for (uint8_t difficulty = 0; difficulty < SeedCatalog::UNSOLVED; difficulty++)
+    {
+        Random picks(12345);
+        Random game;
+        std::vector<bool> seen(seed, false);
+        uint32_t distinct = 0;
+        for (uint32_t press = 0; press < presses; press++)
+        {
+            SeedEntry entry;
+            if (!catalog.pick(difficulty, picks, entry) || entry.difficulty != difficulty)
+            {
+                fprintf(stderr, "Pick %u of %s failed\n", press, SeedCatalog::name(difficulty));
+                return 1;
+            }
+            distinct += !seen[entry.seed];
+            seen[entry.seed] = true;
+
+            // What SwitchShot::New does with the seed, which must not feed back into the next pick.
+            game.seed(entry.seed);
+            for (uint32_t i = 0; i < 3 * COLORS; i++)
+                game.range(48, 255 - 48);
+        }
+
+        // Uniform picks leave a seed out with probability (1 - 1/n)^presses, allow a tenth of the seeds on top.
+        uint32_t size = catalog.size(difficulty);
+        double expected = size * (1 - std::pow(1 - 1.0 / size, presses));
+        bool covered = distinct >= expected - 0.1 * size;
+        printf("%-8s %4u seeds, %u presses, %u distinct (%.0f expected) %s\n", SeedCatalog::name(difficulty), size,
+               presses, distinct, expected, covered ? "ok" : "FAILED");
+        ok = ok && covered;
+    }
+
+    catalog.close();
+    remove(filename);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// Measures Puzzle::compact on column major storage against the row major compact it replaced.
+// "compact us" is Puzzle::compact including its incremental relabel, "row major us" is the old gravity and
+// column collapse alone, "move us" is the gravity and column collapse of Puzzle::compact alone.
+//
+// Usage: compact_bench [moves]
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Puzzle::compact from before the column major storage, on a row major copy of the board.
+static void row_major_compact(std::vector<uint8_t>& data, uint32_t width, uint32_t height,
+                              const std::vector<std::pair<uint32_t, uint32_t>>& hints)
+{
+    uint32_t minx = width, miny = height, maxx = 0, maxy = 0;
+    for (const auto& [x, y] : hints)
+    {
+        minx = std::min(x, minx);
+        miny = std::min(y, miny);
+        maxx = std::max(x, maxx);
+        maxy = std::max(y, maxy);
+    }
+
+    int32_t x_mark = -1;
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        int32_t y_mark = -1;
+        bool moved_one = false;
+        for (int32_t y = maxy; y >= 0 ; y--)
+        {
+            if (y_mark == -1 && data[y * width + x] == Puzzle::EMPTY)
+                y_mark = y;
+            else if ((y_mark != -1 || x_mark != -1) && data[y * width + x] != Puzzle::EMPTY)
+            {
+                int32_t movex = x_mark == -1 ? x : x_mark;
+                int32_t movey = y_mark == -1 ? y : y_mark;
+                std::swap(data[movey * width + movex], data[y * width + x]);
+                if (y_mark != -1) y_mark--;
+                moved_one = true;
+            }
+        }
+        if (x_mark == -1 && maxy == height - 1 && data[(height - 1) * width + x] == Puzzle::EMPTY)
+        {
+            x_mark = x;
+            maxx = width - 1;
+        }
+        else if (x_mark != -1 && (data[(height - 1) * width + x] != Puzzle::EMPTY || moved_one))
+            x_mark++;
+    }
+}
+
+// The gravity and column collapse done by Puzzle::compact, without the relabel that follows.
+static void column_major_move(std::vector<uint8_t>& data, uint32_t width, uint32_t height,
+                              const std::vector<std::pair<uint32_t, uint32_t>>& hints)
+{
+    uint32_t minx = width, maxx = 0, maxy = 0;
+    for (const auto& [x, y] : hints)
+    {
+        minx = std::min(x, minx);
+        maxx = std::max(x, maxx);
+        maxy = std::max(y, maxy);
+    }
+
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        uint8_t* column = &data[x * height];
+        uint32_t to = maxy + 1;
+        for (uint32_t y = maxy + 1; y-- > 0;)
+        {
+            if (column[y] != Puzzle::EMPTY)
+                column[--to] = column[y];
+        }
+        std::fill(column, column + to, Puzzle::EMPTY);
+    }
+
+    uint32_t to = minx;
+    for (uint32_t x = minx; x <= maxx; x++)
+    {
+        if (data[x * height + height - 1] == Puzzle::EMPTY)
+            continue;
+        if (to != x)
+            memmove(&data[to * height], &data[x * height], height);
+        to++;
+    }
+
+    if (to <= maxx)
+    {
+        memmove(&data[to * height], &data[(maxx + 1) * height], (width - maxx - 1) * height);
+        std::fill(data.begin() + (width - (maxx + 1 - to)) * height, data.end(), Puzzle::EMPTY);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t moves = argc > 1 ? atoi(argv[1]) : 200;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {128, 128}, {512, 512}, {1024, 1024}};
+
+    printf("%-10s %6s %12s %12s %12s %8s\n", "board", "moves", "compact us", "move us", "row major us", "ratio");
+    for (const auto& [width, height] : sizes)
+    {
+        Random random(7);
+        Puzzle puzzle(width, height, 4, 7);
+
+        std::vector<uint8_t> rows(width * height), columns = puzzle.data;
+        for (uint32_t x = 0; x < width; x++)
+            for (uint32_t y = 0; y < height; y++)
+                rows[y * width + x] = puzzle.at(x, y);
+
+        Puzzle::cell_list hints;
+        std::vector<std::pair<uint32_t, uint32_t>> points;
+        double compact_us = 0, move_us = 0, row_us = 0;
+        uint32_t done = 0;
+        bool agree = true;
+        uint32_t x, y;
+        for (; done < moves && puzzle.random_move(random, x, y); done++)
+        {
+            const auto& found = puzzle.test(x, y);
+            hints.assign(found.begin(), found.end());
+            points.clear();
+            for (const auto cell : hints)
+            {
+                points.push_back({puzzle.cell_x(cell), puzzle.cell_y(cell)});
+                puzzle.data[cell] = Puzzle::EMPTY;
+                columns[cell] = Puzzle::EMPTY;
+                rows[puzzle.cell_y(cell) * width + puzzle.cell_x(cell)] = Puzzle::EMPTY;
+            }
+
+            auto start = steady_clock::now();
+            puzzle.compact(hints);
+            compact_us += microseconds_since(start);
+
+            start = steady_clock::now();
+            column_major_move(columns, width, height, points);
+            move_us += microseconds_since(start);
+
+            start = steady_clock::now();
+            row_major_compact(rows, width, height, points);
+            row_us += microseconds_since(start);
+        }
+
+        for (x = 0; agree && x < width; x++)
+            for (y = 0; agree && y < height; y++)
+                agree = rows[y * width + x] == puzzle.at(x, y) && columns[puzzle.index(x, y)] == puzzle.at(x, y);
+
+        char board[32];
+        snprintf(board, sizeof(board), "%ux%u", width, height);
+        printf("%-10s %6u %12.2f %12.2f %12.2f %7.1fx%s\n", board, done,
+               done ? compact_us / done : 0, done ? move_us / done : 0, done ? row_us / done : 0,
+               move_us > 0 ? row_us / move_us : 0, agree ? "" : "  (boards differ!)");
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Solves the daily challenge boards of a run of days on every core and writes their par scores to a daily table.
+// A day's par is the best score a beam search reaches on its board, a score players can beat with a better game.
+//
+// Usage: daily_gen [-o table] [-d yyyy-mm-dd] [-n days] [-b beam_width] [-j threads]
+//   The table defaults to ../romfs/daily.bin, where the game looks for it, and starts today (UTC) for a year.
+#include "daily_table.hpp"
+#include "puzzle.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Same as the game.
+static const uint32_t WIDTH = 16, HEIGHT = 8, COLORS = 4;
+
+static DailyEntry solve(uint32_t day, uint32_t beam_width)
+{
+    uint32_t seed = DailyTable::seed(day);
+    Puzzle puzzle(WIDTH, HEIGHT, COLORS, seed);
+
+    Solver::Options options;
+    options.mode = Solver::BEAM;
+    options.table_bits = 16;
+    options.beam_width = beam_width;
+    Solution best = Solver(options).solve(puzzle);
+    return {seed, best.score, static_cast<uint16_t>(best.remaining), 0};
+}
+
+static bool parse_date(const char* text, uint32_t& day)
+{
+    int year;
+    uint32_t month, day_of_month;
+    if (sscanf(text, "%d-%u-%u", &year, &month, &day_of_month) != 3 || month < 1 || month > 12 || day_of_month < 1 ||
+        day_of_month > 31)
+        return false;
+    day = DailyTable::day_number(year, month, day_of_month);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filename = "../romfs/daily.bin";
+    uint32_t first = time(nullptr) / 86400, count = 366, beam_width = 512;
+    uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:d:n:b:j:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': filename = optarg; break;
+            case 'd':
+                if (!parse_date(optarg, first))
+                {
+                    fprintf(stderr, "Bad date %s, expected yyyy-mm-dd\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'n': count = strtoul(optarg, nullptr, 0); break;
+            case 'b': beam_width = std::max(atoi(optarg), 1); break;
+            case 'j': threads = std::max(atoi(optarg), 1); break;
+            default:
+                fprintf(stderr, "Usage: %s [-o table] [-d yyyy-mm-dd] [-n days] [-b beam_width] [-j threads]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    std::vector<DailyEntry> entries(count);
+    std::atomic<uint32_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        workers.emplace_back([&]
+        {
+            for (uint32_t i = next++; i < count; i = next++)
+                entries[i] = solve(first + i, beam_width);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!DailyTable::write(filename, entries, first, WIDTH, HEIGHT, COLORS))
+    {
+        fprintf(stderr, "Could not write %s\n", filename);
+        return 1;
+    }
+
+    // Read every day back the way the game does.
+    DailyTable table;
+    if (!table.open(filename) || !table.matches(WIDTH, HEIGHT, COLORS))
+    {
+        fprintf(stderr, "Could not read back %s\n", filename);
+        return 1;
+    }
+
+    uint64_t total = 0;
+    uint32_t cleared = 0, lowest = UINT32_MAX, highest = 0;
+    for (uint32_t day = first; day < first + count; day++)
+    {
+        DailyEntry entry;
+        if (!table.get(day, entry) || entry.par != entries[day - first].par)
+        {
+            fprintf(stderr, "Day %u reads back wrong from %s\n", day, filename);
+            return 1;
+        }
+        total += entry.par;
+        cleared += entry.remaining == 0;
+        lowest = std::min(lowest, entry.par);
+        highest = std::max(highest, entry.par);
+    }
+
+    printf("days         %u from day %u on %u threads, beam %u\n", count, first, threads, beam_width);
+    printf("days/sec     %.1f\n", count / seconds);
+    printf("total time   %.3fs\n", seconds);
+    if (count > 0)
+        printf("par          %u to %u, %.0f on average, %u boards cleared\n", lowest, highest, double(total) / count, cleared);
+    printf("wrote        %s (%zu bytes)\n", filename, sizeof(DailyTable::Header) + count * sizeof(DailyEntry));
+
+    return 0;
+}
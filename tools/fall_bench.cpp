@@ -0,0 +1,106 @@
+// Measures the falling tiles animation on boards up to 256x256. Random games make a move every few ticks, so tweens
+// of several moves overlap, and every tick updates the tweens and builds the mesh of the moving tiles as a frame would.
+// "compact us" is a match without and with the move list, "tweens" the average and largest number of moving tiles,
+// "start us" sets up the tweens of a move, "update us" and "mesh us" are per tick.
+//
+// Usage: fall_bench [moves]
+#include "bench_util.hpp"
+#include "board_mesh.hpp"
+#include "puzzle.hpp"
+#include "tile_animation.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Same as the game: a tween takes FALL_TICKS, a move is made every MOVE_TICKS.
+constexpr uint32_t FALL_TICKS = 12;
+constexpr uint32_t MOVE_TICKS = 4;
+
+// Picks a random group of two or more, false once the board has none.
+static bool pick(const Puzzle& puzzle, Random& random, uint32_t& x, uint32_t& y)
+{
+    while (puzzle.has_moves())
+    {
+        x = random.below(puzzle.width);
+        y = random.below(puzzle.height);
+        if (puzzle.group_size(x, y) > 1)
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t max_moves = argc > 1 ? atoi(argv[1]) : 300;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {128, 128}, {256, 256}};
+    const BoardMesh::palette colors = {{200, 64, 64}, {64, 200, 64}, {64, 64, 200}, {200, 200, 64}};
+
+    printf("%-10s %11s %11s %10s %10s %10s %10s %10s\n", "board", "compact us", "+moves us", "tweens", "max", "start us",
+           "update us", "mesh us");
+    for (const auto& [width, height] : sizes)
+    {
+        // Plain matches on the same games, for the cost of the move list.
+        Puzzle plain(width, height, 4, 1);
+        Random plain_random(1);
+        double plain_time = 0;
+        uint32_t plain_moves = 0, x, y;
+        while (plain_moves < max_moves && pick(plain, plain_random, x, y))
+        {
+            auto start = steady_clock::now();
+            plain.match(x, y);
+            plain_time += microseconds_since(start);
+            plain_moves++;
+        }
+
+        Puzzle puzzle(width, height, 4, 1);
+        Random random(1);
+        TileAnimation falling;
+        falling.reset(width, height);
+        BoardMesh mesh;
+        Puzzle::move_list moves;
+
+        double compact_time = 0, start_time = 0, update_time = 0, mesh_time = 0;
+        uint64_t tween_total = 0, ticks = 0;
+        uint32_t most = 0, made = 0;
+        bool playing = true;
+        while ((playing && made < max_moves) || falling.active())
+        {
+            if (ticks % MOVE_TICKS == 0 && playing && made < max_moves)
+            {
+                playing = pick(puzzle, random, x, y);
+                if (!playing)
+                    continue;
+
+                auto start = steady_clock::now();
+                puzzle.match(x, y, &moves);
+                compact_time += microseconds_since(start);
+
+                start = steady_clock::now();
+                falling.start(puzzle, moves, FALL_TICKS);
+                start_time += microseconds_since(start);
+                made++;
+            }
+
+            auto start = steady_clock::now();
+            falling.update();
+            update_time += microseconds_since(start);
+
+            start = steady_clock::now();
+            mesh.clear();
+            mesh.add_tweens(falling, colors, 8, 0.5f);
+            mesh_time += microseconds_since(start);
+
+            tween_total += falling.size();
+            most = std::max(most, falling.size());
+            ticks++;
+        }
+
+        char board[32];
+        snprintf(board, sizeof(board), "%ux%u", width, height);
+        printf("%-10s %11.1f %11.1f %10.0f %10u %10.1f %10.1f %10.1f\n", board, plain_time / plain_moves, compact_time / made,
+               double(tween_total) / ticks, most, start_time / made, update_time / ticks, mesh_time / ticks);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Compares Puzzle::test against the original unordered_set/deque flood fill.
+//
+// Usage: flood_fill_bench [queries]
+#include "puzzle.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <unordered_set>
+
+static size_t allocations = 0;
+static volatile size_t sink = 0;
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* ptr = malloc(size);
+    if (!ptr) abort();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+struct pair_hash {
+
+    size_t operator()(const std::pair<uint32_t, uint32_t>& pair) const
+    {
+        return static_cast<size_t>(pair.first) << 32 | pair.second;
+    }
+};
+
+typedef std::unordered_set<std::pair<uint32_t, uint32_t>, pair_hash> point_set;
+
+// The flood fill Puzzle::test used before the scratch based engine.
+static point_set legacy_test(const Puzzle& puzzle, uint32_t x, uint32_t y)
+{
+    point_set visited;
+    const uint32_t width = puzzle.width;
+    const uint32_t height = puzzle.height;
+
+    uint8_t color = puzzle.at(x, y);
+    if (color == Puzzle::EMPTY)
+        return visited;
+
+    std::deque<std::pair<uint32_t, uint32_t>> queue;
+
+    queue.push_back({x, y});
+    visited.insert({x, y});
+
+    while (!queue.empty())
+    {
+        auto [x, y] = queue.front();
+        queue.pop_front();
+
+        if (visited.find({x - 1, y}) == visited.end() && x >= 1         && puzzle.at(x - 1, y) == color)
+        {
+            queue.push_back({x - 1, y});
+            visited.insert({x - 1, y});
+        }
+        if (visited.find({x + 1, y}) == visited.end() && x + 1 < width  && puzzle.at(x + 1, y) == color)
+        {
+            queue.push_back({x + 1, y});
+            visited.insert({x + 1, y});
+        }
+        if (visited.find({x, y - 1}) == visited.end() && y >= 1         && puzzle.at(x, y - 1) == color)
+        {
+            queue.push_back({x, y - 1});
+            visited.insert({x, y - 1});
+        }
+        if (visited.find({x, y + 1}) == visited.end() && y + 1 < height && puzzle.at(x, y + 1) == color)
+        {
+            queue.push_back({x, y + 1});
+            visited.insert({x, y + 1});
+        }
+    }
+
+    if (visited.size() == 1)
+        visited.clear();
+
+    return visited;
+}
+
+template <typename F>
+static double queries_per_second(uint32_t queries, F&& query)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < queries; i++)
+        query(i);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return queries / elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t queries = argc > 1 ? atoi(argv[1]) : 200000;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {256, 256}, {1024, 1024}};
+
+    printf("%-10s %6s %14s %14s %8s %12s\n", "board", "colors", "legacy q/s", "engine q/s", "speedup", "allocations");
+    for (const auto& [width, height] : sizes)
+    {
+        for (uint8_t colors : {2, 4})
+        {
+            Puzzle puzzle(width, height, colors, 1);
+
+            Random random(1);
+            std::vector<std::pair<uint32_t, uint32_t>> probes(4096);
+            for (auto& probe : probes)
+                probe = {random.below(width), random.below(height)};
+
+            bool agree = true;
+            for (const auto& [x, y] : probes)
+                agree = agree && legacy_test(puzzle, x, y).size() == puzzle.test(x, y).size();
+
+            double legacy = queries_per_second(queries / 4, [&](uint32_t i)
+            {
+                auto [x, y] = probes[i % probes.size()];
+                sink += legacy_test(puzzle, x, y).size();
+            });
+
+            // The scratch buffers are already warm, steady state queries must never touch the heap.
+            size_t before = allocations;
+            double engine = queries_per_second(queries, [&](uint32_t i)
+            {
+                auto [x, y] = probes[i % probes.size()];
+                sink += puzzle.test(x, y).size();
+            });
+            size_t allocated = allocations - before;
+
+            char board[32];
+            snprintf(board, sizeof(board), "%ux%u", width, height);
+            printf("%-10s %6u %14.0f %14.0f %7.1fx %12zu%s\n", board, colors, legacy, engine, engine / legacy, allocated,
+                   agree ? "" : "  (results differ!)");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Runs the hint engine on a few boards and reports its playouts per second and how long it takes before the
+// suggested move stops changing, then plays whole games by following the hints against random play.
+// "call us" is the longest the calling thread spent in HintEngine::search or HintEngine::hint, which is
+// all the game thread ever waits on.
+//
+// Usage: hint_bench [playouts]
+#include "bench_util.hpp"
+#include "hint.hpp"
+#include "puzzle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static double max_call_us = 0;
+
+template <typename Call>
+static auto timed_call(Call call)
+{
+    auto start = steady_clock::now();
+    auto result = call();
+    max_call_us = std::max(max_call_us, microseconds_since(start));
+    return result;
+}
+
+// Waits for the search on the last board given to finish, returns its suggestion.
+static uint32_t wait_for_hint(const HintEngine& engine)
+{
+    uint32_t cell;
+    for (;;)
+    {
+        // A hint for the last board means its search started, once it is no longer searching it is done.
+        if (timed_call([&]() {return engine.hint(cell);}) && !engine.stats().searching)
+            return cell;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static uint32_t random_game(Puzzle puzzle, uint64_t seed)
+{
+    Random random(seed);
+    uint32_t score = 0;
+    while (puzzle.has_moves())
+    {
+        uint32_t x = random.below(puzzle.width);
+        uint32_t y = random.below(puzzle.height);
+        if (puzzle.group_size(x, y) > 1)
+        {
+            uint32_t size = puzzle.match(x, y);
+            score += (size - 1) * (size - 1);
+        }
+    }
+    return score;
+}
+
+int main(int argc, char* argv[])
+{
+    HintEngine::Options options;
+    options.max_playouts = argc > 1 ? atoi(argv[1]) : 5000;
+
+    struct Board {uint32_t width, height; uint8_t colors;};
+    const Board boards[] = {{16, 8, 4}, {16, 8, 5}, {32, 16, 4}};
+
+    HintEngine engine(options);
+    engine.start();
+
+    printf("%-12s %6s %10s %12s %10s %10s\n", "board", "seed", "playouts", "playouts/s", "stable s", "total s");
+    for (const auto& board : boards)
+    {
+        for (uint64_t seed = 1; seed <= 3; seed++)
+        {
+            Puzzle puzzle(board.width, board.height, board.colors, seed);
+            timed_call([&]() {engine.search(puzzle); return 0;});
+            wait_for_hint(engine);
+
+            HintStats stats = engine.stats();
+            char name[32];
+            snprintf(name, sizeof(name), "%ux%u/%u", board.width, board.height, board.colors);
+            printf("%-12s %6llu %10llu %12.0f %10.3f %10.3f\n", name, static_cast<unsigned long long>(seed),
+                   static_cast<unsigned long long>(stats.playouts), stats.playouts_per_second, stats.seconds_to_stable,
+                   stats.seconds);
+        }
+    }
+
+    // A board replaced right after it was given must never get a hint, the new one must get a valid one.
+    Puzzle first(16, 8, 4, 10), second(16, 8, 4, 11);
+    timed_call([&]() {engine.search(first); return 0;});
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    timed_call([&]() {engine.search(second); return 0;});
+    uint32_t cell = wait_for_hint(engine);
+    bool cancel_ok = second.group_size(second.cell_x(cell), second.cell_y(cell)) > 1;
+    printf("\nrestart on a new board %s\n", cancel_ok ? "ok" : "FAILED");
+
+    printf("\n%-6s %12s %12s\n", "seed", "hint score", "random avg");
+    for (uint64_t seed = 1; seed <= 5; seed++)
+    {
+        Puzzle puzzle(16, 8, 4, seed);
+        uint64_t random_total = 0;
+        for (uint64_t game = 0; game < 100; game++)
+            random_total += random_game(puzzle, game);
+
+        uint32_t score = 0;
+        while (puzzle.has_moves())
+        {
+            timed_call([&]() {engine.search(puzzle); return 0;});
+            uint32_t move = wait_for_hint(engine);
+            uint32_t size = puzzle.match(puzzle.cell_x(move), puzzle.cell_y(move));
+            score += (size - 1) * (size - 1);
+        }
+        printf("%-6llu %12u %12.1f\n", static_cast<unsigned long long>(seed), score, random_total / 100.0);
+    }
+
+    engine.stop();
+    printf("\ncall us %.1f\n", max_call_us);
+    return cancel_ok ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Plays random games to the end, undoes every move and redoes them all, checking the board at both ends.
+// "copies KB" is what keeping a copy of the board for every move would take instead.
+//
+// Usage: history_bench [max_moves]
+#include "bench_util.hpp"
+#include "history.hpp"
+#include "puzzle.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static bool same_groups(const Puzzle& a, const Puzzle& b)
+{
+    if (a.data != b.data)
+        return false;
+    for (uint32_t x = 0; x < a.width; x++)
+        for (uint32_t y = 0; y < a.height; y++)
+            if (a.group_size(x, y) != b.group_size(x, y))
+                return false;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t max_moves = argc > 1 ? atoi(argv[1]) : 20000;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {128, 128}, {512, 512}};
+
+    printf("%-10s %7s %12s %12s %10s %10s %12s\n", "board", "moves", "undo/s", "redo/s", "bytes/move", "KB", "copies KB");
+    for (const auto& [width, height] : sizes)
+    {
+        Puzzle puzzle(width, height, 4, 11);
+        const Puzzle start_board = puzzle;
+        History history;
+        Random random(11);
+
+        uint32_t moves = 0, x, y;
+        while (moves < max_moves && puzzle.random_move(random, x, y))
+        {
+            history.match(puzzle, x, y);
+            moves++;
+        }
+        const Puzzle end_board = puzzle;
+
+        auto start = steady_clock::now();
+        while (history.undo(puzzle)) {}
+        double undo = moves / seconds_since(start);
+        bool agree = same_groups(puzzle, start_board);
+
+        start = steady_clock::now();
+        while (history.redo(puzzle)) {}
+        double redo = moves / seconds_since(start);
+        agree = agree && same_groups(puzzle, end_board);
+
+        char board[32];
+        snprintf(board, sizeof(board), "%ux%u", width, height);
+        printf("%-10s %7u %12.0f %12.0f %10.1f %10.1f %12.0f%s\n", board, moves, undo, redo,
+               double(history.memory()) / moves, history.memory() / 1024.0, double(moves) * width * height / 1024,
+               agree ? "" : "  (boards differ!)");
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Compares the incremental group labeling done by Puzzle::compact against a full relabel after every match.
+// "match us" is a whole match including the incremental relabel, "relabel us" is Puzzle::relabel alone.
+//
+// Usage: label_bench [moves]
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+    uint32_t moves = argc > 1 ? atoi(argv[1]) : 200;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {128, 128}, {512, 512}, {1024, 1024}};
+
+    printf("%-10s %6s %6s %16s %16s %8s\n", "board", "colors", "moves", "match us", "relabel us", "ratio");
+    for (const auto& [width, height] : sizes)
+    {
+        for (uint8_t colors : {3, 5})
+        {
+            Random random(7);
+            Puzzle incremental(width, height, colors, 7);
+            Puzzle full = incremental;
+
+            std::chrono::duration<double, std::micro> match_time(0), relabel_time(0);
+            uint32_t played = 0;
+            uint32_t x, y;
+            while (played < moves && incremental.random_move(random, x, y))
+            {
+                auto start = steady_clock::now();
+                incremental.match(x, y);
+                match_time += steady_clock::now() - start;
+
+                full.match(x, y);
+                start = steady_clock::now();
+                full.relabel();
+                relabel_time += steady_clock::now() - start;
+                played++;
+            }
+
+            bool agree = incremental.data == full.data;
+            for (uint32_t j = 0; agree && j < height; j++)
+                for (uint32_t i = 0; agree && i < width; i++)
+                    agree = incremental.group_size(i, j) == full.group_size(i, j);
+
+            char board[32];
+            snprintf(board, sizeof(board), "%ux%u", width, height);
+            double per_match = played ? match_time.count() / played : 0;
+            double per_relabel = played ? relabel_time.count() / played : 0;
+            printf("%-10s %6u %6u %16.2f %16.2f %7.1fx%s\n", board, colors, played, per_match, per_relabel,
+                   per_match > 0 ? per_relabel / per_match : 0, agree ? "" : "  (labels differ!)");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Measures the CPU side of drawing the board. The tiles are kept in a render target and only the columns a move
+// changed are drawn again, the selected and hinted groups are an overlay drawn every frame.
+// "full us" builds every tile, as drawing the whole board each frame would, "move quads" and "move us" are the tiles
+// a move of a random game redraws on average and the time to build them. "overlay us" builds the overlay of the
+// largest group and "frame us" is the per frame pulse of the selection. "calls before" is what drawing a tile at a
+// time took (a color and a rectangle per tile), the cached board takes two calls and one for the overlay.
+// The cost of each call inside SDL is only visible on the Switch, in the frame timing overlay.
+//
+// Usage: mesh_bench [frames]
+#include "bench_util.hpp"
+#include "board_mesh.hpp"
+#include "puzzle.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static volatile uint32_t sink = 0;
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames = argc > 1 ? atoi(argv[1]) : 2000;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 32}, {128, 128}, {256, 256}};
+    const BoardMesh::palette colors = {{200, 64, 64}, {64, 200, 64}, {64, 64, 200}, {200, 200, 64}};
+
+    printf("%-10s %8s %13s %10s %11s %9s %11s %9s\n", "board", "tiles", "calls before", "full us", "move quads", "move us",
+           "overlay us", "frame us");
+    for (const auto& [width, height] : sizes)
+    {
+        Puzzle puzzle(width, height, 4, 1);
+        BoardMesh mesh;
+
+        uint32_t rebuilds = std::max(frames / 10, 1u);
+        auto start = steady_clock::now();
+        for (uint32_t i = 0; i < rebuilds; i++)
+        {
+            mesh.clear();
+            mesh.add_columns(puzzle, colors, 8, 0, width - 1);
+            sink += mesh.quads();
+        }
+        double full = microseconds_since(start) / rebuilds;
+
+        uint32_t largest = 0;
+        for (uint32_t cell = 0; cell < width * height; cell++)
+            if (puzzle.group_size(puzzle.cell_x(cell), puzzle.cell_y(cell)) >
+                puzzle.group_size(puzzle.cell_x(largest), puzzle.cell_y(largest)))
+                largest = cell;
+
+        start = steady_clock::now();
+        for (uint32_t i = 0; i < rebuilds; i++)
+        {
+            mesh.clear();
+            mesh.add_group(puzzle, 8, largest);
+            mesh.add_marks(puzzle, 8, largest);
+        }
+        double overlay = microseconds_since(start) / rebuilds;
+
+        // Every tile of the selection pulsing on its own, as the game does.
+        ModulationBank pulses;
+        uint32_t group_cells = puzzle.group_size(puzzle.cell_x(largest), puzzle.cell_y(largest));
+        for (uint32_t i = 0; i < group_cells; i++)
+            pulses.add(0xFF404040, 0xFFFFFFFF, 118, i * 0.1f);
+
+        start = steady_clock::now();
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            pulses.update();
+            pulses.evaluate(0.5f);
+            mesh.set_tints(pulses);
+            sink += mesh.vertices()[0].r;
+        }
+        double frame = microseconds_since(start) / frames;
+
+        // A random game, redrawing the columns each move changed.
+        Random random(1);
+        uint64_t moves = 0, quads = 0;
+        double move_time = 0;
+        puzzle.reset_changes();
+        while (puzzle.has_moves() && moves < 500)
+        {
+            uint32_t x = random.below(width), y = random.below(height);
+            if (puzzle.group_size(x, y) < 2)
+                continue;
+            puzzle.match(x, y);
+
+            start = steady_clock::now();
+            auto [minx, maxx] = puzzle.changes();
+            mesh.clear();
+            mesh.add_columns(puzzle, colors, 8, minx, maxx);
+            puzzle.reset_changes();
+            move_time += microseconds_since(start);
+            quads += mesh.quads();
+            moves++;
+        }
+
+        char board[32];
+        snprintf(board, sizeof(board), "%ux%u", width, height);
+        printf("%-10s %8u %13u %10.1f %11.0f %9.1f %11.1f %9.2f\n", board, width * height, 2 * width * height, full,
+               double(quads) / moves, move_time / moves, overlay, frame);
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Compares pulsing many tiles with a modulator object each, as the game used to, against one ModulationBank, every
+// modulator with its own colors, period and phase. A tick is an update and reading (or evaluating) every color, as a frame would.
+// Rates are millions of modulators a tick per second.
+//
+// Usage: modulation_bench [ticks]
+#include "bench_util.hpp"
+#include "modulation_bank.hpp"
+#include "random.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static volatile uint32_t sink = 0;
+
+static uint32_t rgba(uint32_t r, uint32_t g, uint32_t b)
+{
+    return r | g << 8 | b << 16 | 0xFFu << 24;
+}
+
+// One color going from min to max and back, a step every update, the way the game pulsed its selection before the bank.
+class ColorModulation
+{
+public:
+    void set(uint32_t min, uint32_t max, int32_t spd)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            low[channel] = color[channel] = min >> (8 * channel) & 0xFF;
+            high[channel] = max >> (8 * channel) & 0xFF;
+        }
+        speed = spd;
+        count = speed / 2;
+    }
+
+    void update()
+    {
+        count = (count + 1) % (2 * speed - 2);
+        bool decrease = count / speed;
+        int32_t step = count % speed;
+        if (decrease) step = speed - 2 - step;
+
+        for (int channel = 0; channel < 3; channel++)
+            color[channel] = low[channel] + (high[channel] - low[channel]) * step / speed;
+    }
+
+    uint8_t red() const {return color[0];}
+    uint8_t green() const {return color[1];}
+    uint8_t blue() const {return color[2];}
+
+private:
+    uint8_t color[3];
+    int32_t low[3], high[3];
+    int32_t speed = 2;
+    int32_t count = 0;
+};
+
+int main(int argc, char* argv[])
+{
+    uint32_t ticks = argc > 1 ? atoi(argv[1]) : 200;
+    const uint32_t counts[] = {1000, 10000, 100000, 1000000};
+
+    printf("%-10s %16s %16s %9s %12s\n", "modulators", "single M/s", "bank M/s", "speedup", "bank us/tick");
+    for (const auto count : counts)
+    {
+        Random random(count);
+        std::vector<ColorModulation> singles(count);
+        ModulationBank bank;
+        std::vector<uint32_t> mins(count), maxs(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            mins[i] = rgba(random.below(128), random.below(128), random.below(128));
+            maxs[i] = rgba(128 + random.below(128), 128 + random.below(128), 128 + random.below(128));
+            uint32_t speed = 30 + random.below(60);
+            singles[i].set(mins[i], maxs[i], speed);
+            bank.add(mins[i], maxs[i], 2 * speed - 2, random.below(1000) / 1000.0f);
+        }
+
+        uint32_t rounds = std::max(ticks * 10000 / count, 1u);
+        auto start = steady_clock::now();
+        for (uint32_t tick = 0; tick < rounds; tick++)
+        {
+            uint32_t sum = 0;
+            for (auto& single : singles)
+            {
+                single.update();
+                sum += single.red() + single.green() + single.blue();
+            }
+            sink += sum;
+        }
+        double single_time = seconds_since(start);
+
+        start = steady_clock::now();
+        for (uint32_t tick = 0; tick < rounds; tick++)
+        {
+            bank.update();
+            bank.evaluate(0.5f);
+            sink += bank.red(tick % count);
+        }
+        double bank_time = seconds_since(start);
+
+        // Every color stays between the two it pulses between.
+        bool in_range = true;
+        for (uint32_t i = 0; i < count; i++)
+            in_range &= bank.red(i) >= (mins[i] & 0xFF) && bank.red(i) <= (maxs[i] & 0xFF);
+
+        printf("%-10u %16.1f %16.1f %8.1fx %12.1f%s\n", count, double(count) * rounds / single_time / 1e6,
+               double(count) * rounds / bank_time / 1e6, single_time / bank_time, bank_time / rounds * 1e6,
+               in_range ? "" : "  OUT OF RANGE");
+    }
+
+    return 0;
+}
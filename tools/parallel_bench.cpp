@@ -0,0 +1,58 @@
+// Proves the best score of a fixed set of boards with the exact search on 1 to N threads and reports the speedup.
+// Every thread count has to find the same scores as the single threaded search.
+//
+// Usage: parallel_bench [max_threads] [width] [height]
+#include "puzzle.hpp"
+#include "solver.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    uint32_t max_threads = argc > 1 ? atoi(argv[1]) : std::max(std::thread::hardware_concurrency(), 4u);
+    uint32_t width = argc > 2 ? atoi(argv[2]) : 10;
+    uint32_t height = argc > 3 ? atoi(argv[3]) : 6;
+    const uint32_t seeds[] = {1, 3, 4, 5, 6, 7, 8, 9};
+
+    printf("%ux%u, 4 colors, seeds", width, height);
+    for (const auto seed : seeds)
+        printf(" %u", seed);
+    printf(", %u hardware threads\n", std::thread::hardware_concurrency());
+    printf("%-8s %12s %12s %10s %9s %11s\n", "threads", "nodes", "nodes/sec", "seconds", "speedup", "efficiency");
+
+    std::vector<uint32_t> scores;
+    double base = 0;
+    for (uint32_t threads = 1; threads <= max_threads; threads++)
+    {
+        Solver::Options options;
+        options.threads = threads;
+
+        uint64_t nodes = 0;
+        double seconds = 0;
+        bool agree = true;
+        for (uint32_t i = 0; i < sizeof(seeds) / sizeof(seeds[0]); i++)
+        {
+            Puzzle puzzle(width, height, 4, seeds[i]);
+
+            Solver solver(options);
+            Solution solution = solver.solve(puzzle);
+            nodes += solver.stats().nodes;
+            seconds += solver.stats().seconds;
+
+            if (threads == 1)
+                scores.push_back(solution.score);
+            agree = agree && solution.complete && solution.score == scores[i];
+        }
+
+        if (threads == 1)
+            base = seconds;
+
+        printf("%-8u %12llu %12.0f %10.3f %8.2fx %10.0f%%%s\n", threads, static_cast<unsigned long long>(nodes),
+               nodes / seconds, seconds, base / seconds, 100 * base / seconds / threads, agree ? "" : "  (scores differ!)");
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Measures dealing boards with Random against the rand() loop it replaced, after checking that a few seeds
+// still deal the exact boards recorded below. Those boards are what the game deals on the Switch too,
+// so a mismatch means seeds, the seed catalog and replays no longer carry over between versions.
+//
+// Usage: random_bench [cells]
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+#include "random.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static volatile uint32_t sink = 0;
+
+struct Golden
+{
+    uint64_t seed;
+    uint32_t width;
+    uint32_t height;
+    uint8_t colors;
+    uint64_t hash;
+};
+
+static const Golden GOLDEN[] =
+{
+    {1,          16,  8, 4, 0x6CCCB239C990F9FAULL},
+    {1591000000, 16,  8, 4, 0x0A988C0086F46EFCULL},
+    {42,         16,  8, 6, 0x4E0AB72C56BCE360ULL},
+    {7,          40, 20, 5, 0xA2506733D5A3C9D2ULL},
+};
+
+// FNV-1a over the colors of the board, read through at() so the hash does not depend on the storage order.
+static uint64_t board_hash(const Puzzle& puzzle)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint32_t y = 0; y < puzzle.height; y++)
+    {
+        for (uint32_t x = 0; x < puzzle.width; x++)
+        {
+            hash ^= puzzle.at(x, y);
+            hash *= 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t cells = argc > 1 ? strtoull(argv[1], nullptr, 0) : 1 << 26;
+
+    bool golden = true;
+    for (const auto& entry : GOLDEN)
+    {
+        uint64_t hash = board_hash(Puzzle(entry.width, entry.height, entry.colors, entry.seed));
+        if (hash != entry.hash)
+        {
+            printf("seed %llu on %ux%u with %u colors deals %016llX, expected %016llX\n",
+                   static_cast<unsigned long long>(entry.seed), entry.width, entry.height, entry.colors,
+                   static_cast<unsigned long long>(hash), static_cast<unsigned long long>(entry.hash));
+            golden = false;
+        }
+    }
+    printf("golden seeds %s\n\n", golden ? "match" : "DIFFER");
+
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {128, 128}, {1024, 1024}};
+    printf("%-10s %6s %14s %14s %8s %12s\n", "board", "colors", "rand() cell/s", "fill cell/s", "speedup", "boards/s");
+    for (const auto& [width, height] : sizes)
+    {
+        for (uint8_t colors : {4, 6})
+        {
+            std::vector<uint8_t> data(width * height);
+            uint32_t rounds = std::max<uint64_t>(cells / data.size(), 1);
+
+            srand(1);
+            auto start = steady_clock::now();
+            for (uint32_t i = 0; i < rounds; i++)
+            {
+                for (auto& cell : data)
+                    cell = rand() % colors;
+                sink += data[i % data.size()];
+            }
+            double legacy = double(rounds) * data.size() / seconds_since(start);
+
+            Random random(1);
+            start = steady_clock::now();
+            for (uint32_t i = 0; i < rounds; i++)
+            {
+                random.fill(data.data(), data.size(), colors);
+                sink += data[i % data.size()];
+            }
+            double fill = double(rounds) * data.size() / seconds_since(start);
+
+            // A whole deal, including the group labeling of the new board.
+            uint32_t boards = std::max<uint32_t>(rounds / 16, 1);
+            start = steady_clock::now();
+            for (uint32_t i = 0; i < boards; i++)
+                sink += Puzzle(width, height, colors, i).has_moves();
+            double dealt = boards / seconds_since(start);
+
+            char board[32];
+            snprintf(board, sizeof(board), "%ux%u", width, height);
+            printf("%-10s %6u %14.0f %14.0f %7.1fx %12.0f\n", board, colors, legacy, fill, fill / legacy, dealt);
+        }
+    }
+
+    return golden ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// Plays a replay back, checks it and measures how fast it replays. Can also record a random game to try it on.
+//
+// Usage: replay [-g seed] [-w width] [-h height] [-c colors] [-H] [-r repeats] [-v] file
+//   -g   record a random game (with a few undos and redos) on the board dealt by seed into file first
+//   -H   record the board hash after every action, playback then checks them
+//   -r   play the replay this many times to time it
+//   -v   print the board hash after every action
+#include "history.hpp"
+#include "puzzle.hpp"
+#include "replay.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+static bool record(const char* filename, uint64_t seed, uint32_t width, uint32_t height, uint8_t colors, bool hashes)
+{
+    Puzzle puzzle(width, height, colors, seed);
+    History history;
+    ReplayWriter writer;
+    if (!writer.open(filename, seed, puzzle, hashes))
+        return false;
+
+    Random random(seed);
+    while (puzzle.has_moves())
+    {
+        uint32_t x, y;
+        do
+        {
+            x = random.below(width);
+            y = random.below(height);
+        }
+        while (puzzle.group_size(x, y) < 2);
+
+        uint32_t roll = random.below(100);
+        if (roll < 5 && history.can_undo())
+        {
+            history.undo(puzzle);
+            writer.undo(puzzle);
+        }
+        else if (roll < 8 && history.can_redo())
+        {
+            history.redo(puzzle);
+            writer.redo(puzzle);
+        }
+        else
+        {
+            uint32_t cell = puzzle.index(x, y);
+            history.match(puzzle, x, y);
+            writer.move(cell, puzzle);
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed = 0;
+    bool generate = false, hashes = false, verbose = false;
+    uint32_t width = 16, height = 8, colors = 4, repeats = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "g:w:h:c:Hr:v")) != -1)
+    {
+        switch (opt)
+        {
+            case 'g': seed = strtoull(optarg, nullptr, 0); generate = true; break;
+            case 'w': width = atoi(optarg); break;
+            case 'h': height = atoi(optarg); break;
+            case 'c': colors = atoi(optarg); break;
+            case 'H': hashes = true; break;
+            case 'r': repeats = std::max(atoi(optarg), 1); break;
+            case 'v': verbose = true; break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind + 1 != argc)
+    {
+        fprintf(stderr, "Usage: %s [-g seed] [-w width] [-h height] [-c colors] [-H] [-r repeats] [-v] file\n", argv[0]);
+        return 1;
+    }
+    const char* filename = argv[optind];
+
+    if (generate && !record(filename, seed, width, height, colors, hashes))
+    {
+        fprintf(stderr, "Could not write %s\n", filename);
+        return 1;
+    }
+
+    Replay replay;
+    if (!replay.load(filename))
+    {
+        fprintf(stderr, "Could not read %s\n", filename);
+        return 1;
+    }
+
+    const ReplayHeader& info = replay.info();
+    printf("board        %ux%u, %u colors, seed %llu%s\n", info.width, info.height, info.colors,
+           static_cast<unsigned long long>(info.seed), replay.has_hashes() ? ", with hashes" : "");
+
+    const Puzzle start = replay.deal();
+    Puzzle puzzle = start;
+    uint32_t score, actions;
+    std::vector<uint64_t> hash_list;
+    bool valid = replay.play(puzzle, score, actions, verbose ? &hash_list : nullptr);
+
+    for (uint32_t i = 0; i < hash_list.size(); i++)
+        printf("%6u %016llX\n", i + 1, static_cast<unsigned long long>(hash_list[i]));
+    printf("actions      %u\n", actions);
+    printf("score        %u\n", score);
+    printf("final hash   %016llX\n", static_cast<unsigned long long>(board_hash(puzzle)));
+
+    if (repeats > 1)
+    {
+        // Only the playback is timed, every run starts from a copy of the dealt board.
+        double seconds = 0;
+        for (uint32_t i = 0; i < repeats; i++)
+        {
+            puzzle = start;
+            auto begin = std::chrono::steady_clock::now();
+            replay.play(puzzle, score, actions);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+        printf("actions/sec  %.0f\n", double(actions) * repeats / seconds);
+    }
+
+    if (!valid)
+    {
+        printf("replay diverged after %u actions!\n", actions);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Plays random matches on boards from 16x8 to 4096x4096 and shows how the cost of a match grows with the board.
+// "removed" and "moved" are the average cells a match empties and tiles it moves, "match us" the average match
+// and "ns/cell" that over the cells removed and moved. A match costing the same per cell on every board scales
+// with the work it does rather than with the board. The wide board empties columns, moving every column right of them.
+//
+// Usage: scale_bench [moves]
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Picks a random group of two or more, false once the board has none.
+static bool pick(const Puzzle& puzzle, Random& random, uint32_t& x, uint32_t& y)
+{
+    while (puzzle.has_moves())
+    {
+        x = random.below(puzzle.width);
+        y = random.below(puzzle.height);
+        if (puzzle.group_size(x, y) > 1)
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t max_moves = argc > 1 ? atoi(argv[1]) : 500;
+    const std::pair<uint32_t, uint32_t> sizes[] = {{16, 8}, {64, 64}, {256, 256}, {1024, 1024}, {4096, 4096},
+                                                   {4096, 8}};
+
+    printf("%-10s %10s %10s %10s %10s %10s %10s\n", "board", "deal ms", "matches", "removed", "moved", "match us",
+           "ns/cell");
+    for (const auto& [width, height] : sizes)
+    {
+        auto start = steady_clock::now();
+        Puzzle puzzle(width, height, 4, 3);
+        double deal_time = microseconds_since(start);
+
+        // The same game again with the move list, only to count the tiles each match moves.
+        Puzzle counted = puzzle;
+        Puzzle::move_list moves;
+        Random random(3);
+        double match_time = 0;
+        uint64_t removed = 0, moved = 0;
+        uint32_t made = 0, x, y;
+        while (made < max_moves && pick(puzzle, random, x, y))
+        {
+            start = steady_clock::now();
+            uint32_t matched = puzzle.match(x, y);
+            match_time += microseconds_since(start);
+
+            counted.match(x, y, &moves);
+            removed += matched;
+            moved += moves.size() - matched;
+            made++;
+        }
+
+        char board[32];
+        snprintf(board, sizeof(board), "%ux%u", width, height);
+        printf("%-10s %10.1f %10u %10.1f %10.1f %10.2f %10.1f\n", board, deal_time / 1000, made, double(removed) / made,
+               double(moved) / made, match_time / made, match_time * 1000 / (removed + moved));
+    }
+
+    return 0;
+}
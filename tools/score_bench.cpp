@@ -0,0 +1,143 @@
+// Measures what saving high scores costs the game thread. A frame plays a match on a 16x8 board, dealing a new one
+// when it runs out, and every few frames a game is added to the store, far more often than games end. The same
+// frames run without saving ("none"), with the store writing on its own thread as the game does ("store") and
+// waiting for each write as saving on the game thread would ("blocking"). Frame times only count the game thread,
+// "save us" is the worst time a frame spent handing over a game. On a single core the writing thread preempts the
+// game thread, which shows in the frame times but not in the save times. A host disk is much faster than the
+// console's SD card, which only widens the gap on the console.
+//
+// Usage: score_bench [-f frames] [-e every] [-d directory]
+#include "bench_util.hpp"
+#include "puzzle.hpp"
+#include "score_store.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+enum Saving {NONE, STORE, BLOCKING};
+
+static void remove_files(const std::string& snapshot, const std::string& journal)
+{
+    remove(snapshot.c_str());
+    remove((snapshot + ".tmp").c_str());
+    remove(journal.c_str());
+}
+
+static void run(const char* name, Saving saving, uint32_t frames, uint32_t every, const std::string& snapshot,
+                const std::string& journal)
+{
+    remove_files(snapshot, journal);
+    ScoreStore store;
+    if (saving != NONE)
+        store.open(snapshot, journal);
+
+    Puzzle puzzle(16, 8, 4, 1);
+    Random random(1);
+    uint32_t score = 0, games = 0;
+    std::vector<double> times(frames);
+    double worst_save = 0;
+
+    for (uint32_t frame = 0; frame < frames; frame++)
+    {
+        auto start = steady_clock::now();
+
+        if (!puzzle.has_moves())
+            puzzle = Puzzle(16, 8, 4, random.next());
+        uint32_t x, y;
+        do
+        {
+            x = random.below(puzzle.width);
+            y = random.below(puzzle.height);
+        } while (puzzle.group_size(x, y) < 2);
+        uint32_t size = puzzle.match(x, y);
+        score += (size - 1) * (size - 1);
+
+        if (saving != NONE && frame % every == every - 1)
+        {
+            auto save_start = steady_clock::now();
+            ScoreRecord record{};
+            record.seed = games;
+            record.score = score;
+            record.mode = games % HighScores::MODES;
+            store.add(record);
+            if (saving == BLOCKING)
+                store.flush();
+            worst_save = std::max(worst_save, microseconds_since(save_start));
+            games++;
+        }
+
+        times[frame] = microseconds_since(start);
+    }
+
+    store.flush();
+    ScoreStore::IoStats io = store.io_stats();
+    store.close();
+
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for (double time : times)
+        total += time;
+    printf("%-9s %8u %10.2f %10.1f %10.1f %10.1f %9u %9u %10u %10u\n", name, games, total / frames,
+           times[frames * 99 / 100], times.back(), worst_save, io.appended, io.snapshots, io.worst_append_us,
+           io.worst_snapshot_us);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames = 20000, every = 20;
+    std::string directory = "build";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:e:d:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'f': frames = std::max(atoi(optarg), 1); break;
+            case 'e': every = std::max(atoi(optarg), 1); break;
+            case 'd': directory = optarg; break;
+            default:
+                fprintf(stderr, "Usage: %s [-f frames] [-e every] [-d directory]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    const std::string snapshot = directory + "/score_bench.bin";
+    const std::string journal = directory + "/score_bench.journal";
+
+    printf("%u frames, a game saved every %u\n", frames, every);
+    printf("%-9s %8s %10s %10s %10s %10s %9s %9s %10s %10s\n", "saving", "games", "mean us", "p99 us", "worst us",
+           "save us", "appended", "snapshots", "append us", "snapshot us");
+    run("none", NONE, frames, every, snapshot, journal);
+    run("store", STORE, frames, every, snapshot, journal);
+    run("blocking", BLOCKING, frames, every, snapshot, journal);
+
+    // Startup from a snapshot and the journal written after it, up to a game short of compacting again.
+    remove_files(snapshot, journal);
+    {
+        ScoreStore store;
+        store.open(snapshot, journal);
+        for (uint32_t i = 0; i < ScoreStore::COMPACT_EVERY * 3 - 1; i++)
+        {
+            ScoreRecord record{};
+            record.score = i;
+            store.add(record);
+        }
+        store.flush();
+    }
+    ScoreStore store;
+    auto start = steady_clock::now();
+    bool loaded = store.open(snapshot, journal);
+    double load_time = microseconds_since(start);
+    const HighScores::Stats& stats = store.scores().stats[0];
+    printf("load      %.0f us, %s, %u games, best %u\n", load_time, loaded ? "ok" : "FAILED", stats.games,
+           store.scores().best(0));
+    store.close();
+    remove_files(snapshot, journal);
+
+    return loaded && stats.games == ScoreStore::COMPACT_EVERY * 3 - 1 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// Classifies the boards the game deals for a range of seeds on every core and writes them to a seed catalog.
+//
+// Usage: seed_gen [-o catalog] [-f first_seed] [-n count] [-j threads]
+//   The catalog defaults to ../romfs/seeds.bin, which is where the game looks for it.
+#include "puzzle.hpp"
+#include "seed_catalog.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const uint32_t WIDTH = 16, HEIGHT = 8, COLORS = 4;
+// Clear board beams tried from the narrowest, the first that clears the board gives its difficulty.
+static const uint32_t BEAM_WIDTHS[] = {16, 64, 256};
+
+static SeedEntry classify(uint32_t seed)
+{
+    Puzzle puzzle(WIDTH, HEIGHT, COLORS, seed);
+    SeedEntry entry{seed, 0, static_cast<uint16_t>(WIDTH * HEIGHT), SeedCatalog::UNSOLVED, 0};
+
+    Solver::Options options;
+    options.mode = Solver::BEAM;
+    options.table_bits = 16;
+    options.beam_width = 128;
+    Solution best = Solver(options).solve(puzzle);
+    entry.score = best.score;
+    entry.remaining = best.remaining;
+
+    options.objective = Solver::CLEAR_BOARD;
+    for (uint8_t difficulty = 0; difficulty < sizeof(BEAM_WIDTHS) / sizeof(BEAM_WIDTHS[0]); difficulty++)
+    {
+        options.beam_width = BEAM_WIDTHS[difficulty];
+        Solution solution = Solver(options).solve(puzzle);
+        entry.score = std::max(entry.score, solution.score);
+        entry.remaining = std::min<uint16_t>(entry.remaining, solution.remaining);
+        if (solution.remaining == 0)
+        {
+            entry.difficulty = difficulty;
+            break;
+        }
+    }
+
+    return entry;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filename = "../romfs/seeds.bin";
+    uint32_t first = 1, count = 1000;
+    uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:f:n:j:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': filename = optarg; break;
+            case 'f': first = strtoul(optarg, nullptr, 0); break;
+            case 'n': count = strtoul(optarg, nullptr, 0); break;
+            case 'j': threads = std::max(atoi(optarg), 1); break;
+            default:
+                fprintf(stderr, "Usage: %s [-o catalog] [-f first_seed] [-n count] [-j threads]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    std::vector<SeedEntry> entries(count);
+    std::atomic<uint32_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        workers.emplace_back([&]
+        {
+            for (uint32_t i = next++; i < count; i = next++)
+                entries[i] = classify(first + i);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!SeedCatalog::write(filename, entries, WIDTH, HEIGHT, COLORS))
+    {
+        fprintf(stderr, "Could not write %s\n", filename);
+        return 1;
+    }
+
+    // Read it back the way the game does.
+    SeedCatalog catalog;
+    if (!catalog.open(filename))
+    {
+        fprintf(stderr, "Could not read back %s\n", filename);
+        return 1;
+    }
+
+    printf("seeds        %u to %u on %u threads\n", first, first + count - 1, threads);
+    printf("seeds/sec    %.1f\n", count / seconds);
+    printf("total time   %.3fs\n", seconds);
+    for (uint8_t difficulty = 0; difficulty < SeedCatalog::DIFFICULTIES; difficulty++)
+    {
+        printf("%-12s %u", SeedCatalog::name(difficulty), catalog.size(difficulty));
+        SeedEntry entry;
+        if (catalog.get(difficulty, 0, entry))
+            printf(" (first seed %u, best score %u, %u left)", entry.seed, entry.score, entry.remaining);
+        printf("\n");
+    }
+    printf("wrote        %s\n", filename);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Solves the board the game deals for a seed and reports search statistics.
+//
+// Usage: solve [-s seed] [-w width] [-h height] [-c colors] [-b beam_width] [-n node_limit] [-t table_bits] [-j threads] [-x] [-p]
+//   -b   beam search with the given width instead of exact search
+//   -j   threads sharing the exact search
+//   -x   look for a line that clears the board instead of the best score
+//   -p   search on Puzzle even if the board fits in a bitboard
+#include "puzzle.hpp"
+#include "solver.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+int main(int argc, char* argv[])
+{
+    time_t seed = 1;
+    uint32_t width = 16, height = 8, colors = 4;
+    Solver::Options options;
+    options.node_limit = 20000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:w:h:c:b:n:t:j:xp")) != -1)
+    {
+        switch (opt)
+        {
+            case 's': seed = strtoll(optarg, nullptr, 0); break;
+            case 'w': width = atoi(optarg); break;
+            case 'h': height = atoi(optarg); break;
+            case 'c': colors = atoi(optarg); break;
+            case 'b': options.mode = Solver::BEAM; options.beam_width = atoi(optarg); break;
+            case 'n': options.node_limit = strtoull(optarg, nullptr, 0); break;
+            case 't': options.table_bits = atoi(optarg); break;
+            case 'j': options.threads = atoi(optarg); break;
+            case 'x': options.objective = Solver::CLEAR_BOARD; break;
+            case 'p': options.force_puzzle = true; break;
+            default:
+                fprintf(stderr, "Usage: %s [-s seed] [-w width] [-h height] [-c colors] [-b beam_width] [-n node_limit] [-t table_bits] [-j threads] [-x] [-p]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    Puzzle puzzle(width, height, colors, seed);
+
+    Solver solver(options);
+    Solution solution = solver.solve(puzzle);
+    const SolverStats& stats = solver.stats();
+
+    printf("board        %ux%u, %u colors, seed %lld\n", width, height, colors, static_cast<long long>(seed));
+    printf("mode         %s, %s on %s, %u thread%s\n", options.mode == Solver::EXACT ? "exact" : "beam",
+           options.objective == Solver::MAX_SCORE ? "max score" : "clear board", stats.backend,
+           stats.threads, stats.threads == 1 ? "" : "s");
+    printf("score        %u%s\n", solution.score, solution.complete ? " (optimal)" : "");
+    printf("remaining    %u tiles\n", solution.remaining);
+    printf("moves        %zu\n", solution.moves.size());
+    printf("nodes        %llu\n", static_cast<unsigned long long>(stats.nodes));
+    printf("nodes/sec    %.0f\n", stats.seconds > 0 ? stats.nodes / stats.seconds : 0);
+    printf("tt hit rate  %.2f%% of %llu probes\n", stats.table_probes ? 100.0 * stats.table_hits / stats.table_probes : 0,
+           static_cast<unsigned long long>(stats.table_probes));
+    printf("time to best %.3fs\n", stats.seconds_to_best);
+    printf("total time   %.3fs\n", stats.seconds);
+
+    // Replay the line on the real board to make sure it scores what the solver claims.
+    uint32_t score = 0;
+    printf("line        ");
+    for (const auto cell : solution.moves)
+    {
+        printf(" %u,%u", puzzle.cell_x(cell), puzzle.cell_y(cell));
+        score += Solver::score(puzzle.match(puzzle.cell_x(cell), puzzle.cell_y(cell)));
+    }
+    printf("\n");
+
+    if (score != solution.score)
+    {
+        printf("replaying the line scored %u!\n", score);
+        return 1;
+    }
+
+    return 0;
+}